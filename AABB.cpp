@@ -0,0 +1,84 @@
+#include "AABB.h"
+
+#include <limits>
+
+namespace hvk
+{
+    AABB::AABB()
+        : mMin(
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max())
+        , mMax(
+            -std::numeric_limits<float>::max(),
+            -std::numeric_limits<float>::max(),
+            -std::numeric_limits<float>::max())
+    {
+    }
+
+    AABB::AABB(const Vector& min, const Vector& max)
+        : mMin(min)
+        , mMax(max)
+    {
+    }
+
+    void AABB::Grow(const Vector& point)
+    {
+        mMin = Float3(Vector::Min(mMin.Load(), point));
+        mMax = Float3(Vector::Max(mMax.Load(), point));
+    }
+
+    void AABB::Grow(const AABB& other)
+    {
+        mMin = Float3(Vector::Min(mMin.Load(), other.mMin.Load()));
+        mMax = Float3(Vector::Max(mMax.Load(), other.mMax.Load()));
+    }
+
+    Vector AABB::getMin() const
+    {
+        return mMin.Load();
+    }
+
+    Vector AABB::getMax() const
+    {
+        return mMax.Load();
+    }
+
+    Vector AABB::Centroid() const
+    {
+        return 0.5f * (mMin.Load() + mMax.Load());
+    }
+
+    Vector AABB::Extent() const
+    {
+        return mMax.Load() - mMin.Load();
+    }
+
+    float AABB::SurfaceArea() const
+    {
+        if (IsEmpty())
+        {
+            return 0.f;
+        }
+        const auto e = Extent();
+        return 2.f * (e.X() * e.Y() + e.Y() * e.Z() + e.Z() * e.X());
+    }
+
+    bool AABB::IsEmpty() const
+    {
+        return mMin.x > mMax.x || mMin.y > mMax.y || mMin.z > mMax.z;
+    }
+
+    bool AABB::operator== (const AABB& rhs) const
+    {
+        return mMin.x == rhs.mMin.x && mMin.y == rhs.mMin.y && mMin.z == rhs.mMin.z &&
+               mMax.x == rhs.mMax.x && mMax.y == rhs.mMax.y && mMax.z == rhs.mMax.z;
+    }
+
+    AABB AABB::Union(const AABB& lhs, const AABB& rhs)
+    {
+        AABB result = lhs;
+        result.Grow(rhs);
+        return result;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef RTX_WEEKEND_AABB_H
+#define RTX_WEEKEND_AABB_H
+
+#include "Vector.h"
+#include "Float3.h"
+
+namespace hvk
+{
+    class AABB
+    {
+    public:
+        // default constructed bounds are empty (min > max) so that growing
+        // them by any point or box yields exactly that point or box
+        AABB();
+        AABB(const Vector& min, const Vector& max);
+
+        void Grow(const Vector& point);
+        void Grow(const AABB& other);
+
+        Vector getMin() const;
+        Vector getMax() const;
+        Vector Centroid() const;
+        Vector Extent() const;
+        float SurfaceArea() const;
+        bool IsEmpty() const;
+
+        bool operator== (const AABB& rhs) const;
+
+        static AABB Union(const AABB& lhs, const AABB& rhs);
+
+    private:
+        // packed, so a BVH node with its two indices fits in 32 bytes
+        Float3 mMin;
+        Float3 mMax;
+    };
+}
+
+#endif //RTX_WEEKEND_AABB_H
@@ -0,0 +1,150 @@
+#include "AccumulationBuffer.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace hvk
+{
+    // "RTXA", and the layout version after it
+    constexpr uint32_t kCheckpointMagic = 0x41585452;
+    constexpr uint32_t kCheckpointVersion = 2;
+
+    AccumulationBuffer::AccumulationBuffer()
+        : mFile()
+        , mMemorySums()
+        , mMemoryCounts()
+        , mWidth(0)
+        , mHeight(0)
+        , mSums(nullptr)
+        , mCounts(nullptr)
+        , mNumPixels(0)
+        , mImageHash(0)
+        , mRun(0)
+    {
+
+    }
+
+    AccumulationBuffer::AccumulationBuffer(uint16_t width, uint16_t height)
+        : AccumulationBuffer()
+    {
+        mWidth = width;
+        mHeight = height;
+        mNumPixels = width * height;
+        mMemorySums.resize(mNumPixels);
+        mMemoryCounts.resize(mNumPixels);
+        mSums = mMemorySums.data();
+        mCounts = mMemoryCounts.data();
+    }
+
+    std::optional<AccumulationBuffer> AccumulationBuffer::MapCheckpoint(
+        const std::string& path,
+        uint16_t width,
+        uint16_t height)
+    {
+        // header, then every pixel's sum, then every pixel's count
+        const size_t numPixels = width * height;
+        const size_t sumsOffset = sizeof(Header);
+        const size_t countsOffset = sumsOffset + numPixels * sizeof(Float3);
+        const size_t size = countsOffset + numPixels * sizeof(uint32_t);
+
+        auto file = MappedFile::Open(path, size);
+        if (!file.has_value())
+        {
+            return std::nullopt;
+        }
+
+        // a new file is all zeros
+        auto* header = reinterpret_cast<Header*>(file->getData());
+        if (header->magic == 0)
+        {
+            *header = { kCheckpointMagic, kCheckpointVersion, width, height, 0, 0 };
+        }
+        else if (header->magic != kCheckpointMagic || header->version != kCheckpointVersion ||
+            header->width != width || header->height != height)
+        {
+            return std::nullopt;
+        }
+
+        AccumulationBuffer buffer;
+        buffer.mWidth = width;
+        buffer.mHeight = height;
+        buffer.mNumPixels = numPixels;
+        buffer.mSums = reinterpret_cast<Float3*>(file->getData() + sumsOffset);
+        buffer.mCounts = reinterpret_cast<uint32_t*>(file->getData() + countsOffset);
+        buffer.mImageHash = header->imageHash;
+        buffer.mRun = header->runs;
+        buffer.mFile = std::move(file);
+        return std::optional<AccumulationBuffer>(std::move(buffer));
+    }
+
+    std::optional<AccumulationBuffer> AccumulationBuffer::OpenCheckpoint(
+        const std::string& path,
+        uint16_t width,
+        uint16_t height,
+        uint64_t imageHash)
+    {
+        auto buffer = MapCheckpoint(path, width, height);
+        if (!buffer.has_value())
+        {
+            return std::nullopt;
+        }
+
+        // a new checkpoint has neither runs nor samples, so it takes on the image
+        auto* header = reinterpret_cast<Header*>(buffer->mFile->getData());
+        if (header->runs == 0)
+        {
+            header->imageHash = imageHash;
+        }
+        else if (header->imageHash != imageHash)
+        {
+            return std::nullopt;
+        }
+        ++header->runs;
+        buffer->mImageHash = imageHash;
+        return buffer;
+    }
+
+    std::optional<AccumulationBuffer> AccumulationBuffer::OpenCheckpoint(const std::string& path)
+    {
+        // only an existing checkpoint says what size it is
+        Header header = {};
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kCheckpointMagic)
+        {
+            return std::nullopt;
+        }
+        file.close();
+        return MapCheckpoint(path, header.width, header.height);
+    }
+
+    void AccumulationBuffer::Merge(const AccumulationBuffer& other)
+    {
+        for (size_t pixel = 0; pixel < mNumPixels; ++pixel)
+        {
+            Add(pixel, other.mSums[pixel].Load(), other.mCounts[pixel]);
+        }
+    }
+
+    Float3 AccumulationBuffer::Resolve(size_t pixel) const
+    {
+        if (mCounts[pixel] == 0)
+        {
+            return Float3();
+        }
+        return Float3(mSums[pixel].Load() / static_cast<float>(mCounts[pixel]));
+    }
+
+    uint32_t AccumulationBuffer::getMinSampleCount(size_t beginPixel, size_t endPixel) const
+    {
+        if (beginPixel >= endPixel)
+        {
+            return 0;
+        }
+        return *std::min_element(mCounts + beginPixel, mCounts + endPixel);
+    }
+
+    bool AccumulationBuffer::Sync()
+    {
+        return !mFile.has_value() || mFile->Flush();
+    }
+}
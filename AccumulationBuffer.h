@@ -0,0 +1,106 @@
+#ifndef RTX_WEEKEND_ACCUMULATIONBUFFER_H
+#define RTX_WEEKEND_ACCUMULATIONBUFFER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Float3.h"
+#include "Vector.h"
+#include "MappedFile.h"
+
+namespace hvk
+{
+    // The sum of every sample traced into each pixel and how many there were,
+    // from which the image is resolved. Either held in memory or mapped from a
+    // checkpoint file, in which case a render killed part way keeps every pixel
+    // finished before and can be resumed, or a finished render can be given
+    // more samples later.
+    class AccumulationBuffer
+    {
+    public:
+        AccumulationBuffer(uint16_t width, uint16_t height);
+
+        // Maps the checkpoint at path, resuming from it if it was written for the
+        // same image and creating it if it does not exist. imageHash stands for
+        // everything but the size that decides what the image looks like, see
+        // main. Returns nullopt if it cannot be mapped or belongs to another
+        // image. Each call counts a run of the checkpoint, see getRun.
+        static std::optional<AccumulationBuffer> OpenCheckpoint(
+            const std::string& path,
+            uint16_t width,
+            uint16_t height,
+            uint64_t imageHash);
+        // maps an existing checkpoint of whatever image it was written for
+        static std::optional<AccumulationBuffer> OpenCheckpoint(const std::string& path);
+
+        // Safe to call from many threads as long as they add to different pixels
+        void Add(size_t pixel, const Vector& sum, uint32_t numSamples)
+        {
+            mSums[pixel] = Float3(mSums[pixel].Load() + sum);
+            mCounts[pixel] += numSamples;
+        }
+
+        // Adds every sample of other, which must be the same size. Sums add up
+        // and so do counts, so each pixel's mean weighs the buffers by how many
+        // samples each gave it.
+        void Merge(const AccumulationBuffer& other);
+
+        // the mean of the pixel's samples, black if it has none
+        Float3 Resolve(size_t pixel) const;
+
+        Float3 getSum(size_t pixel) const { return mSums[pixel]; }
+        uint32_t getSampleCount(size_t pixel) const { return mCounts[pixel]; }
+        // forgets every sample of the pixel
+        void Reset(size_t pixel)
+        {
+            mSums[pixel] = Float3();
+            mCounts[pixel] = 0;
+        }
+
+        uint16_t getWidth() const { return mWidth; }
+        uint16_t getHeight() const { return mHeight; }
+        // fewest samples of the pixels in [beginPixel, endPixel)
+        uint32_t getMinSampleCount(size_t beginPixel, size_t endPixel) const;
+        bool isCheckpointed() const { return mFile.has_value(); }
+        // of the image the checkpoint was written for, 0 in memory
+        uint64_t getImageHash() const { return mImageHash; }
+        // How many renders opened the checkpoint before this one, 0 in memory.
+        // A resumed render mixes it into its seed, so that it doesn't draw the
+        // samples the checkpoint already holds all over again.
+        uint32_t getRun() const { return mRun; }
+
+        // writes a checkpoint out to disk, does nothing in memory
+        bool Sync();
+
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint16_t width;
+            uint16_t height;
+            uint32_t runs;
+            uint64_t imageHash;
+        };
+
+        AccumulationBuffer();
+        // maps the checkpoint at path as an image of the size, creating it
+        // zeroed if it does not exist, and checks all but its image hash
+        static std::optional<AccumulationBuffer> MapCheckpoint(const std::string& path, uint16_t width, uint16_t height);
+
+        std::optional<MappedFile> mFile;
+        std::vector<Float3> mMemorySums;
+        std::vector<uint32_t> mMemoryCounts;
+        uint16_t mWidth;
+        uint16_t mHeight;
+        Float3* mSums;
+        uint32_t* mCounts;
+        size_t mNumPixels;
+        uint64_t mImageHash;
+        uint32_t mRun;
+    };
+}
+
+#endif //RTX_WEEKEND_ACCUMULATIONBUFFER_H
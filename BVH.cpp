@@ -0,0 +1,452 @@
+#include "BVH.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <numeric>
+
+namespace hvk
+{
+    struct BVH::Split
+    {
+        bool valid;
+        size_t axis;
+        // primitives whose centroid falls in a bin below this one go left
+        uint32_t bin;
+        float cost;
+        float centroidMin;
+        float binScale;
+        AABB leftBounds;
+        AABB rightBounds;
+    };
+
+    struct _Bin
+    {
+        AABB bounds;
+        uint32_t count = 0;
+    };
+
+    BVH::BVH()
+        : mNodes()
+        , mPrimitiveIndices()
+        , mParents()
+        , mPrimitiveLeaves()
+        , mCostSum(0.0)
+        , mMaxDepth(0)
+    {
+    }
+
+    void BVH::Build(const std::vector<AABB>& primitiveBounds, ThreadPool* pool, BVHBuildQuality quality)
+    {
+        const auto numPrimitives = static_cast<uint32_t>(primitiveBounds.size());
+        mNodes.clear();
+        mPrimitiveIndices.resize(numPrimitives);
+        std::iota(mPrimitiveIndices.begin(), mPrimitiveIndices.end(), 0);
+        if (numPrimitives == 0)
+        {
+            ComputeTopology();
+            return;
+        }
+
+        BuildState state{ primitiveBounds, std::vector<Vector>(numPrimitives), 1 };
+
+        // a binary tree with N leaves has at most 2N - 1 nodes
+        mNodes.resize(numPrimitives * 2 - 1);
+        mNodes[0] = BVHNode{ AABB(), 0, numPrimitives };
+
+        // small builds aren't worth the cost of waking the pool
+        if (numPrimitives < kParallelSubtreeThreshold)
+        {
+            pool = nullptr;
+        }
+
+        if (quality == BVHBuildQuality::Fast)
+        {
+            BuildLBVH(state, pool);
+        }
+        else if (pool == nullptr)
+        {
+            for (uint32_t i = 0; i < numPrimitives; ++i)
+            {
+                state.centroids[i] = primitiveBounds[i].Centroid();
+                mNodes[0].bounds.Grow(primitiveBounds[i]);
+            }
+            BuildSubtree(state, 0, nullptr);
+        }
+        else
+        {
+            const size_t chunkSize = (numPrimitives + pool->getNumThreads() - 1) / pool->getNumThreads();
+            std::vector<AABB> partialBounds((numPrimitives + chunkSize - 1) / chunkSize);
+            pool->ParallelFor(numPrimitives, chunkSize, [&](size_t begin, size_t end) {
+                auto& bounds = partialBounds[begin / chunkSize];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    state.centroids[i] = primitiveBounds[i].Centroid();
+                    bounds.Grow(primitiveBounds[i]);
+                }
+            });
+            for (const auto& bounds : partialBounds)
+            {
+                mNodes[0].bounds.Grow(bounds);
+            }
+
+            // Large nodes near the top are split here, with their binning spread
+            // across the pool. Everything below that is handed to the pool as
+            // independent subtree jobs, but only once the large nodes are done:
+            // ParallelFor waits on everything queued, so subtree jobs queued
+            // earlier would hold up every binning pass after them.
+            std::vector<uint32_t> largeNodes = { 0 };
+            std::vector<uint32_t> subtrees;
+            while (!largeNodes.empty())
+            {
+                const auto nodeIndex = largeNodes.back();
+                largeNodes.pop_back();
+                if (!SplitNode(state, nodeIndex, pool))
+                {
+                    continue;
+                }
+
+                const auto left = mNodes[nodeIndex].leftFirst;
+                for (uint32_t child = left; child <= left + 1; ++child)
+                {
+                    if (mNodes[child].count >= kParallelBinningThreshold)
+                    {
+                        largeNodes.push_back(child);
+                    }
+                    else
+                    {
+                        subtrees.push_back(child);
+                    }
+                }
+            }
+            for (const auto child : subtrees)
+            {
+                pool->QueueWork([this, &state, child, pool]() {
+                    BuildSubtree(state, child, pool);
+                });
+            }
+            pool->Wait();
+        }
+
+        mNodes.resize(state.nodesUsed.load());
+        ComputeTopology();
+    }
+
+    void BVH::ComputeTopology()
+    {
+        mParents.assign(mNodes.size(), 0);
+        mPrimitiveLeaves.assign(mPrimitiveIndices.size(), 0);
+        mCostSum = 0.0;
+        mMaxDepth = 0;
+        // children are always allocated after their parent, so a node's depth
+        // is known by the time it is reached
+        std::vector<uint32_t> depths(mNodes.size(), 0);
+        for (uint32_t i = 0; i < mNodes.size(); ++i)
+        {
+            const auto& node = mNodes[i];
+            mCostSum += GetNodeCost(node);
+            mMaxDepth = std::max(mMaxDepth, depths[i]);
+            if (node.IsLeaf())
+            {
+                for (uint32_t p = 0; p < node.count; ++p)
+                {
+                    mPrimitiveLeaves[mPrimitiveIndices[node.leftFirst + p]] = i;
+                }
+            }
+            else
+            {
+                mParents[node.leftFirst] = i;
+                mParents[node.leftFirst + 1] = i;
+                depths[node.leftFirst] = depths[i] + 1;
+                depths[node.leftFirst + 1] = depths[i] + 1;
+            }
+        }
+    }
+
+    float BVH::GetNodeCost(const BVHNode& node) const
+    {
+        const float cost = node.IsLeaf() ? node.count * kIntersectionCost : kTraversalCost;
+        return cost * node.bounds.SurfaceArea();
+    }
+
+    void BVH::Refit(const std::vector<uint32_t>& primitives, const std::vector<AABB>& primitiveBounds)
+    {
+        for (const auto primitive : primitives)
+        {
+            uint32_t nodeIndex = mPrimitiveLeaves[primitive];
+            while (true)
+            {
+                auto& node = mNodes[nodeIndex];
+                AABB bounds;
+                if (node.IsLeaf())
+                {
+                    for (uint32_t p = 0; p < node.count; ++p)
+                    {
+                        bounds.Grow(primitiveBounds[mPrimitiveIndices[node.leftFirst + p]]);
+                    }
+                }
+                else
+                {
+                    bounds = AABB::Union(mNodes[node.leftFirst].bounds, mNodes[node.leftFirst + 1].bounds);
+                }
+
+                // nothing above can change if this node didn't
+                if (bounds == node.bounds)
+                {
+                    break;
+                }
+
+                mCostSum -= GetNodeCost(node);
+                node.bounds = bounds;
+                mCostSum += GetNodeCost(node);
+
+                if (nodeIndex == 0)
+                {
+                    break;
+                }
+                nodeIndex = mParents[nodeIndex];
+            }
+        }
+    }
+
+    void BVH::BuildSubtree(BuildState& state, uint32_t nodeIndex, ThreadPool* pool)
+    {
+        if (!SplitNode(state, nodeIndex, nullptr))
+        {
+            return;
+        }
+
+        const auto left = mNodes[nodeIndex].leftFirst;
+        for (uint32_t child = left; child <= left + 1; ++child)
+        {
+            if (pool != nullptr && mNodes[child].count >= kParallelSubtreeThreshold)
+            {
+                pool->QueueWork([this, &state, child, pool]() {
+                    BuildSubtree(state, child, pool);
+                });
+            }
+            else
+            {
+                BuildSubtree(state, child, pool);
+            }
+        }
+    }
+
+    bool BVH::SplitNode(BuildState& state, uint32_t nodeIndex, ThreadPool* pool)
+    {
+        const uint32_t first = mNodes[nodeIndex].leftFirst;
+        const uint32_t count = mNodes[nodeIndex].count;
+        if (count <= 1)
+        {
+            return false;
+        }
+
+        auto split = FindSplit(state, nodeIndex, pool);
+        const float leafCost = count * kIntersectionCost;
+        if (split.valid && split.cost >= leafCost && count <= kMaxLeafSize)
+        {
+            return false;
+        }
+
+        const auto begin = mPrimitiveIndices.begin() + first;
+        const auto end = begin + count;
+        auto middle = begin;
+        if (split.valid)
+        {
+            middle = std::partition(begin, end, [&](uint32_t primitive) {
+                const auto bin = static_cast<uint32_t>(
+                    (state.centroids[primitive].GetComponent(split.axis) - split.centroidMin) * split.binScale);
+                return std::min(bin, kNumBins - 1) < split.bin;
+            });
+        }
+        else
+        {
+            // every centroid is in the same spot, so no plane can separate them
+            if (count <= kMaxLeafSize)
+            {
+                return false;
+            }
+            middle = begin + count / 2;
+            for (auto it = begin; it != middle; ++it)
+            {
+                split.leftBounds.Grow(state.primitiveBounds[*it]);
+            }
+            for (auto it = middle; it != end; ++it)
+            {
+                split.rightBounds.Grow(state.primitiveBounds[*it]);
+            }
+        }
+
+        const auto leftCount = static_cast<uint32_t>(middle - begin);
+        const auto leftIndex = state.nodesUsed.fetch_add(2);
+        mNodes[leftIndex] = BVHNode{ split.leftBounds, first, leftCount };
+        mNodes[leftIndex + 1] = BVHNode{ split.rightBounds, first + leftCount, count - leftCount };
+        mNodes[nodeIndex].leftFirst = leftIndex;
+        mNodes[nodeIndex].count = 0;
+        return true;
+    }
+
+    BVH::Split BVH::FindSplit(BuildState& state, uint32_t nodeIndex, ThreadPool* pool) const
+    {
+        using Bins = std::array<std::array<_Bin, kNumBins>, 3>;
+
+        const auto& node = mNodes[nodeIndex];
+        const uint32_t first = node.leftFirst;
+        const uint32_t count = node.count;
+        const bool parallel = pool != nullptr && count >= kParallelBinningThreshold;
+        const size_t chunkSize = parallel ? (count + pool->getNumThreads() - 1) / pool->getNumThreads() : count;
+        const size_t numChunks = (count + chunkSize - 1) / chunkSize;
+
+        // bins are laid out over the bounds of the centroids rather than the
+        // primitives, so every bin can actually receive primitives
+        std::vector<AABB> partialCentroidBounds(numChunks);
+        const auto growCentroidBounds = [&](size_t begin, size_t end) {
+            auto& bounds = partialCentroidBounds[begin / chunkSize];
+            for (size_t i = begin; i < end; ++i)
+            {
+                bounds.Grow(state.centroids[mPrimitiveIndices[first + i]]);
+            }
+        };
+        if (parallel)
+        {
+            pool->ParallelFor(count, chunkSize, growCentroidBounds);
+        }
+        else
+        {
+            growCentroidBounds(0, count);
+        }
+        AABB centroidBounds;
+        for (const auto& bounds : partialCentroidBounds)
+        {
+            centroidBounds.Grow(bounds);
+        }
+
+        const auto centroidMin = centroidBounds.getMin();
+        const auto centroidExtent = centroidBounds.Extent();
+        std::array<float, 3> binScales = {};
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const float extent = centroidExtent.GetComponent(axis);
+            binScales[axis] = extent > 0.f ? kNumBins / extent : 0.f;
+        }
+
+        std::vector<Bins> partialBins(numChunks);
+        const auto fillBins = [&](size_t begin, size_t end) {
+            auto& bins = partialBins[begin / chunkSize];
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto primitive = mPrimitiveIndices[first + i];
+                const auto& centroid = state.centroids[primitive];
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    const auto bin = std::min(
+                        static_cast<uint32_t>((centroid.GetComponent(axis) - centroidMin.GetComponent(axis)) * binScales[axis]),
+                        kNumBins - 1);
+                    bins[axis][bin].bounds.Grow(state.primitiveBounds[primitive]);
+                    ++bins[axis][bin].count;
+                }
+            }
+        };
+        if (parallel)
+        {
+            pool->ParallelFor(count, chunkSize, fillBins);
+        }
+        else
+        {
+            fillBins(0, count);
+        }
+        Bins bins = partialBins[0];
+        for (size_t chunk = 1; chunk < numChunks; ++chunk)
+        {
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                for (uint32_t bin = 0; bin < kNumBins; ++bin)
+                {
+                    bins[axis][bin].bounds.Grow(partialBins[chunk][axis][bin].bounds);
+                    bins[axis][bin].count += partialBins[chunk][axis][bin].count;
+                }
+            }
+        }
+
+        // sweep the split planes between bins from both sides, the SAH cost of a
+        // split being the primitive count of each side weighted by its area
+        Split best = {};
+        best.valid = false;
+        best.cost = std::numeric_limits<float>::max();
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            if (binScales[axis] == 0.f)
+            {
+                continue;
+            }
+
+            std::array<float, kNumBins - 1> leftCosts = {};
+            std::array<AABB, kNumBins - 1> leftBounds = {};
+            AABB runningBounds;
+            uint32_t runningCount = 0;
+            for (uint32_t plane = 0; plane < kNumBins - 1; ++plane)
+            {
+                runningBounds.Grow(bins[axis][plane].bounds);
+                runningCount += bins[axis][plane].count;
+                leftCosts[plane] = runningCount * runningBounds.SurfaceArea();
+                leftBounds[plane] = runningBounds;
+            }
+
+            runningBounds = AABB();
+            runningCount = 0;
+            for (uint32_t plane = kNumBins - 1; plane > 0; --plane)
+            {
+                runningBounds.Grow(bins[axis][plane].bounds);
+                runningCount += bins[axis][plane].count;
+                const float cost = leftCosts[plane - 1] + runningCount * runningBounds.SurfaceArea();
+                if (runningCount > 0 && runningCount < count && cost < best.cost)
+                {
+                    best.valid = true;
+                    best.axis = axis;
+                    best.bin = plane;
+                    best.cost = cost;
+                    best.centroidMin = centroidMin.GetComponent(axis);
+                    best.binScale = binScales[axis];
+                    best.leftBounds = leftBounds[plane - 1];
+                    best.rightBounds = runningBounds;
+                }
+            }
+        }
+
+        const float area = node.bounds.SurfaceArea();
+        if (best.valid && area > 0.f)
+        {
+            best.cost = kTraversalCost + kIntersectionCost * best.cost / area;
+        }
+        return best;
+    }
+
+    bool BVH::IsEmpty() const
+    {
+        return mNodes.empty();
+    }
+
+    AABB BVH::getBounds() const
+    {
+        if (mNodes.empty())
+        {
+            return AABB();
+        }
+        return mNodes[0].bounds;
+    }
+
+    size_t BVH::getNumNodes() const
+    {
+        return mNodes.size();
+    }
+
+    float BVH::getSAHCost() const
+    {
+        if (mNodes.empty())
+        {
+            return 0.f;
+        }
+        const float rootArea = mNodes[0].bounds.SurfaceArea();
+        return rootArea > 0.f ? static_cast<float>(mCostSum / rootArea) : 0.f;
+    }
+}
@@ -0,0 +1,387 @@
+#ifndef RTX_WEEKEND_BVH_H
+#define RTX_WEEKEND_BVH_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "AABB.h"
+#include "Ray.h"
+#include "hittest.h"
+#include "ThreadPool.h"
+#include "RayPacket.h"
+#include "NodeCacheSimulator.h"
+#include "RayStats.h"
+#include "math.h"
+
+namespace hvk
+{
+    // bounds of the product of the intervals [a0, a1] and [b0, b1]
+    inline std::pair<float, float> _IntervalProduct(float a0, float a1, float b0, float b1)
+    {
+        const float p0 = a0 * b0;
+        const float p1 = a0 * b1;
+        const float p2 = a1 * b0;
+        const float p3 = a1 * b1;
+        return std::make_pair(std::min(std::min(p0, p1), std::min(p2, p3)), std::max(std::max(p0, p1), std::max(p2, p3)));
+    }
+
+    enum class BVHBuildQuality
+    {
+        // binned SAH, slower to build but faster to trace
+        High,
+        // linear BVH over Morton ordered primitives, for per frame rebuilds
+        Fast
+    };
+
+    struct BVHNode
+    {
+        AABB bounds;
+        // index of the left child for interior nodes (the right child
+        // always follows it), or of the first primitive for leaves
+        uint32_t leftFirst;
+        // number of primitives in a leaf, 0 for interior nodes
+        uint32_t count;
+
+        bool IsLeaf() const { return count > 0; }
+    };
+
+    // two nodes, and so both children of a node, share a 64 byte cache line
+    static_assert(sizeof(BVHNode) == 32);
+
+    // Bounding volume hierarchy over an arbitrary set of primitives. The
+    // hierarchy only knows about primitive bounds; intersecting the actual
+    // primitives is left to the owner through the callback passed to Intersect,
+    // which lets the same structure serve as both bottom level (spheres, boxes)
+    // and top level (instances).
+    class BVH
+    {
+    public:
+        BVH();
+
+        // When a pool is given, independent subtrees are built as separate jobs.
+        // High quality builds also bin large nodes in parallel, fast builds
+        // radix sort the Morton codes in parallel.
+        void Build(
+            const std::vector<AABB>& primitiveBounds,
+            ThreadPool* pool = nullptr,
+            BVHBuildQuality quality = BVHBuildQuality::High);
+
+        // Updates the bounds of the leaves holding the given primitives and of
+        // their ancestors, leaving the topology as it is. Cheap, but the tree
+        // degrades as primitives move away from where it was built.
+        void Refit(const std::vector<uint32_t>& primitives, const std::vector<AABB>& primitiveBounds);
+
+        bool IsEmpty() const;
+        AABB getBounds() const;
+        size_t getNumNodes() const;
+        // expected cost of tracing a ray through the tree, in units of
+        // primitive intersections
+        float getSAHCost() const;
+
+        // intersectPrimitive(primitiveIndex, tMax) is called for every primitive
+        // in a leaf the ray reaches, and should lower tMax when it finds a closer hit
+        template <typename IntersectFn>
+        void Intersect(const Ray& ray, float& tMax, IntersectFn&& intersectPrimitive) const
+        {
+            if (mNodes.empty())
+            {
+                return;
+            }
+
+            const auto origin = ray.getOrigin();
+            const auto direction = ray.getDirection();
+            const Vector inverseDirection(
+                math::slabInverse(direction.X()), math::slabInverse(direction.Y()), math::slabInverse(direction.Z()));
+
+            auto* const cache = NodeCacheSimulator::Current();
+            if (cache != nullptr)
+            {
+                cache->Touch(&mNodes[0]);
+            }
+            RTX_WEEKEND_COUNT(nodeVisits, 1);
+
+            const auto rootEntry = hit::AABBRayIntersect(mNodes[0].bounds, origin, inverseDirection, tMax);
+            if (!rootEntry.has_value())
+            {
+                return;
+            }
+
+            // nodes are pushed along with the distance at which the ray enters
+            // them, so a node can be skipped once a closer hit has been found
+            std::pair<uint32_t, float> fixedStack[kMaxStackDepth];
+            std::vector<std::pair<uint32_t, float>> deepStack;
+            auto* const stack = GetStack(fixedStack, deepStack);
+            size_t stackSize = 0;
+            stack[stackSize++] = std::make_pair(0u, rootEntry.value());
+            while (stackSize > 0)
+            {
+                const auto [nodeIndex, entry] = stack[--stackSize];
+                if (entry > tMax)
+                {
+                    continue;
+                }
+
+                const auto& node = mNodes[nodeIndex];
+                if (node.IsLeaf())
+                {
+                    for (uint32_t i = 0; i < node.count; ++i)
+                    {
+                        intersectPrimitive(mPrimitiveIndices[node.leftFirst + i], tMax);
+                    }
+                    continue;
+                }
+
+                // visit the nearer child first so tMax shrinks as early as possible
+                const auto left = node.leftFirst;
+                const auto right = node.leftFirst + 1;
+                if (cache != nullptr)
+                {
+                    cache->Touch(&mNodes[left]);
+                    cache->Touch(&mNodes[right]);
+                }
+                RTX_WEEKEND_COUNT(nodeVisits, 2);
+                const auto leftEntry = hit::AABBRayIntersect(mNodes[left].bounds, origin, inverseDirection, tMax);
+                const auto rightEntry = hit::AABBRayIntersect(mNodes[right].bounds, origin, inverseDirection, tMax);
+                if (leftEntry.has_value() && rightEntry.has_value())
+                {
+                    if (leftEntry.value() <= rightEntry.value())
+                    {
+                        stack[stackSize++] = std::make_pair(right, rightEntry.value());
+                        stack[stackSize++] = std::make_pair(left, leftEntry.value());
+                    }
+                    else
+                    {
+                        stack[stackSize++] = std::make_pair(left, leftEntry.value());
+                        stack[stackSize++] = std::make_pair(right, rightEntry.value());
+                    }
+                }
+                else if (leftEntry.has_value())
+                {
+                    stack[stackSize++] = std::make_pair(left, leftEntry.value());
+                }
+                else if (rightEntry.has_value())
+                {
+                    stack[stackSize++] = std::make_pair(right, rightEntry.value());
+                }
+            }
+        }
+
+        // Traces the masked lanes of a packet together, so each node is fetched
+        // once for the whole packet. A node is first tested against interval
+        // bounds on the packet's origins and inverse directions, which rejects
+        // it for every ray at once; only nodes that survive are tested per lane.
+        // intersectPrimitive(primitiveIndex, laneMask, tMax) is called with the
+        // lanes that reach a leaf and should lower tMax for lanes it hits.
+        template <size_t N, typename IntersectFn>
+        void IntersectPacket(
+            const RayPacket<N>& packet,
+            typename RayPacket<N>::Mask mask,
+            std::array<float, N>& tMax,
+            IntersectFn&& intersectPrimitive) const
+        {
+            using Mask = typename RayPacket<N>::Mask;
+            if (mNodes.empty() || mask == 0)
+            {
+                return;
+            }
+
+            const std::array<const std::array<float, N>*, 3> origins = {
+                &packet.originX, &packet.originY, &packet.originZ };
+            const std::array<const std::array<float, N>*, 3> inverseDirections = {
+                &packet.inverseDirectionX, &packet.inverseDirectionY, &packet.inverseDirectionZ };
+
+            // interval bounds over the active lanes
+            std::array<float, 3> originMin;
+            std::array<float, 3> originMax;
+            std::array<float, 3> inverseMin;
+            std::array<float, 3> inverseMax;
+            originMin.fill(std::numeric_limits<float>::max());
+            originMax.fill(-std::numeric_limits<float>::max());
+            inverseMin.fill(std::numeric_limits<float>::max());
+            inverseMax.fill(-std::numeric_limits<float>::max());
+            for (size_t lane = 0; lane < N; ++lane)
+            {
+                if ((mask & (Mask(1) << lane)) == 0)
+                {
+                    continue;
+                }
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    originMin[axis] = std::min(originMin[axis], (*origins[axis])[lane]);
+                    originMax[axis] = std::max(originMax[axis], (*origins[axis])[lane]);
+                    inverseMin[axis] = std::min(inverseMin[axis], (*inverseDirections[axis])[lane]);
+                    inverseMax[axis] = std::max(inverseMax[axis], (*inverseDirections[axis])[lane]);
+                }
+            }
+
+            const auto nodeMask = [&](const BVHNode& node) -> Mask {
+                const auto minimum = node.bounds.getMin();
+                const auto maximum = node.bounds.getMax();
+
+                // conservative test of the whole packet using interval arithmetic
+                float packetTMax = 0.f;
+                for (size_t lane = 0; lane < N; ++lane)
+                {
+                    packetTMax = std::max(packetTMax, (mask & (Mask(1) << lane)) ? tMax[lane] : 0.f);
+                }
+                float intervalEnter = 0.f;
+                float intervalExit = packetTMax;
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    const auto lower = _IntervalProduct(
+                        minimum.GetComponent(axis) - originMax[axis],
+                        minimum.GetComponent(axis) - originMin[axis],
+                        inverseMin[axis],
+                        inverseMax[axis]);
+                    const auto upper = _IntervalProduct(
+                        maximum.GetComponent(axis) - originMax[axis],
+                        maximum.GetComponent(axis) - originMin[axis],
+                        inverseMin[axis],
+                        inverseMax[axis]);
+                    intervalEnter = std::max(intervalEnter, std::min(lower.first, upper.first));
+                    intervalExit = std::min(intervalExit, std::max(lower.second, upper.second));
+                }
+                if (intervalEnter > intervalExit)
+                {
+                    return 0;
+                }
+
+                // per lane slab test
+                Mask hits = 0;
+                for (size_t lane = 0; lane < N; ++lane)
+                {
+                    float enter = 0.f;
+                    float exit = tMax[lane];
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        const float t0 = (minimum.GetComponent(axis) - (*origins[axis])[lane]) * (*inverseDirections[axis])[lane];
+                        const float t1 = (maximum.GetComponent(axis) - (*origins[axis])[lane]) * (*inverseDirections[axis])[lane];
+                        enter = std::max(enter, std::min(t0, t1));
+                        exit = std::min(exit, std::max(t0, t1));
+                    }
+                    hits |= Mask(enter <= exit) << lane;
+                }
+                return hits & mask;
+            };
+
+            // coherent rays share their direction signs, so the first active
+            // lane is representative for ordering children front to back
+            size_t firstLane = 0;
+            while ((mask & (Mask(1) << firstLane)) == 0)
+            {
+                ++firstLane;
+            }
+            const Vector representativeDirection(
+                packet.directionX[firstLane], packet.directionY[firstLane], packet.directionZ[firstLane]);
+
+            auto* const cache = NodeCacheSimulator::Current();
+            uint32_t fixedStack[kMaxStackDepth];
+            std::vector<uint32_t> deepStack;
+            auto* const stack = GetStack(fixedStack, deepStack);
+            size_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0)
+            {
+                const auto& node = mNodes[stack[--stackSize]];
+                if (cache != nullptr)
+                {
+                    cache->Touch(&node);
+                }
+                RTX_WEEKEND_COUNT(nodeVisits, 1);
+                const Mask lanes = nodeMask(node);
+                if (lanes == 0)
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    for (uint32_t i = 0; i < node.count; ++i)
+                    {
+                        intersectPrimitive(mPrimitiveIndices[node.leftFirst + i], lanes, tMax);
+                    }
+                    continue;
+                }
+
+                const auto left = node.leftFirst;
+                const auto right = node.leftFirst + 1;
+                const auto leftToRight = mNodes[right].bounds.Centroid() - mNodes[left].bounds.Centroid();
+                if (Vector::Dot(leftToRight, representativeDirection) >= 0.f)
+                {
+                    stack[stackSize++] = right;
+                    stack[stackSize++] = left;
+                }
+                else
+                {
+                    stack[stackSize++] = left;
+                    stack[stackSize++] = right;
+                }
+            }
+        }
+
+    private:
+        // Traversal stacks live on the stack for trees up to this deep, see GetStack
+        static constexpr size_t kMaxStackDepth = 64;
+        static constexpr uint32_t kMaxLeafSize = 8;
+        static constexpr uint32_t kNumBins = 16;
+        static constexpr float kTraversalCost = 1.f;
+        static constexpr float kIntersectionCost = 1.f;
+        // nodes with at least this many primitives are binned across the pool
+        static constexpr uint32_t kParallelBinningThreshold = 1 << 16;
+        // children with at least this many primitives are built as their own job
+        static constexpr uint32_t kParallelSubtreeThreshold = 1 << 10;
+
+        // Morton codes are quantized more finely once there are enough
+        // primitives for 10 bits per axis to produce many duplicate codes
+        static constexpr uint32_t kMaxPrimitivesFor30BitMorton = 1 << 18;
+        static constexpr uint32_t kMaxLBVHLeafSize = 4;
+
+        struct BuildState
+        {
+            const std::vector<AABB>& primitiveBounds;
+            std::vector<Vector> centroids;
+            std::atomic<uint32_t> nodesUsed;
+        };
+        struct Split;
+
+        void BuildSubtree(BuildState& state, uint32_t nodeIndex, ThreadPool* pool);
+        bool SplitNode(BuildState& state, uint32_t nodeIndex, ThreadPool* pool);
+        Split FindSplit(BuildState& state, uint32_t nodeIndex, ThreadPool* pool) const;
+
+        void BuildLBVH(BuildState& state, ThreadPool* pool);
+        template <typename MortonCode>
+        void BuildLBVHWithCodes(BuildState& state, const AABB& centroidBounds, ThreadPool* pool);
+        template <typename MortonCode>
+        void EmitLBVHSubtree(BuildState& state, const std::vector<MortonCode>& codes, uint32_t nodeIndex, ThreadPool* pool);
+        void RefitAllNodes(const std::vector<AABB>& primitiveBounds);
+        void ComputeTopology();
+        float GetNodeCost(const BVHNode& node) const;
+
+        // Depth first traversal holds at most one node per level plus the two
+        // children just pushed, which fits fixedStack unless the build made an
+        // unusually deep tree, in which case deepStack is sized to fit
+        template <typename Entry>
+        Entry* GetStack(Entry (&fixedStack)[kMaxStackDepth], std::vector<Entry>& deepStack) const
+        {
+            if (mMaxDepth + 1 <= kMaxStackDepth)
+            {
+                return fixedStack;
+            }
+            deepStack.resize(mMaxDepth + 1);
+            return deepStack.data();
+        }
+
+        std::vector<BVHNode> mNodes;
+        std::vector<uint32_t> mPrimitiveIndices;
+        std::vector<uint32_t> mParents;
+        std::vector<uint32_t> mPrimitiveLeaves;
+        // sum of the area weighted cost of every node, kept up to date by Refit
+        double mCostSum;
+        // levels below the root of the deepest leaf
+        uint32_t mMaxDepth;
+    };
+}
+
+#endif //RTX_WEEKEND_BVH_H
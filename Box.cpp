@@ -23,4 +23,40 @@ namespace hvk
     {
         return mSides;
     }
+
+    Vector _IntersectPlanes(const Plane& p1, const Plane& p2, const Plane& p3)
+    {
+        // The point shared by three planes N . X = d is:
+        //  X = (d1 (N2 x N3) + d2 (N3 x N1) + d3 (N1 x N2)) / (N1 . (N2 x N3))
+
+        const auto n1 = p1.getDirection();
+        const auto n2 = p2.getDirection();
+        const auto n3 = p3.getDirection();
+        const auto n2n3 = Vector::Cross(n2, n3);
+        const auto denominator = Vector::Dot(n1, n2n3);
+        return (Vector::Dot(n1, p1.getOrigin()) * n2n3 +
+                Vector::Dot(n2, p2.getOrigin()) * Vector::Cross(n3, n1) +
+                Vector::Dot(n3, p3.getOrigin()) * Vector::Cross(n1, n2)) / denominator;
+    }
+
+    AABB Box::getBounds() const
+    {
+        // every corner of the box lies on exactly one side out of each
+        // opposing pair, so the bounds are spanned by the 8 triple intersections
+        const std::array<std::pair<Side, Side>, 3> opposing = {
+            std::make_pair(Side::Top, Side::Bottom),
+            std::make_pair(Side::Front, Side::Back),
+            std::make_pair(Side::Left, Side::Right)
+        };
+
+        AABB bounds;
+        for (size_t corner = 0; corner < 8; ++corner)
+        {
+            const auto& a = (corner & 1) ? opposing[0].second : opposing[0].first;
+            const auto& b = (corner & 2) ? opposing[1].second : opposing[1].first;
+            const auto& c = (corner & 4) ? opposing[2].second : opposing[2].first;
+            bounds.Grow(_IntersectPlanes(getSide(a), getSide(b), getSide(c)));
+        }
+        return bounds;
+    }
 }
\ No newline at end of file
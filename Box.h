@@ -2,6 +2,7 @@
 #define RTX_WEEKEND_BOX_H
 
 #include "Plane.h"
+#include "AABB.h"
 #include <utility>
 #include <vector>
 #include <array>
@@ -34,6 +35,7 @@ namespace hvk
 
         Plane getSide(Side s) const;
         const BoxSides& getSides() const;
+        AABB getBounds() const;
 
     private:
         BoxSides mSides;
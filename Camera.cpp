@@ -7,17 +7,17 @@ namespace hvk
         Vector lookFrom,
         Vector lookAt,
         Vector up,
-        double verticalFov,
-        double aspectRatio,
-        double near,
-        double far)
+        Real verticalFov,
+        Real aspectRatio,
+        Real near,
+        Real far)
         : mOrigin(0.f, 0.f, 0.0f)
         , mHorizontal()
         , mVertical()
         , mLowerLeft()
     {
         auto theta = math::degreesToRadians(verticalFov);
-        auto h = tan(theta / far);
+        auto h = std::tan(theta / far);
         auto viewportHeight = far * h;
         auto viewportWidth = aspectRatio * viewportHeight;
 
@@ -26,13 +26,13 @@ namespace hvk
         auto v = Vector::Cross(w, u);
 
         mOrigin = lookFrom;
-        mHorizontal = viewportWidth * u;
-        mVertical = viewportHeight * v;
+        mHorizontal = static_cast<float>(viewportWidth) * u;
+        mVertical = static_cast<float>(viewportHeight) * v;
         mLowerLeft = mOrigin - (mHorizontal / 2) - (mVertical / 2) - w;
     }
 
-    Ray Camera::GetRay(double u, double v) const
+    Ray Camera::GetRay(Real u, Real v) const
     {
-        return Ray(mOrigin, mLowerLeft + (u * mHorizontal) + (v * mVertical) - mOrigin);
+        return Ray(mOrigin, mLowerLeft + (static_cast<float>(u) * mHorizontal) + (static_cast<float>(v) * mVertical) - mOrigin);
     }
 }
@@ -3,6 +3,7 @@
 
 #include "Vector.h"
 #include "Ray.h"
+#include "Real.h"
 
 namespace hvk
 {
@@ -13,11 +14,11 @@ namespace hvk
             Vector lookFrom,
             Vector lookAt,
             Vector up,
-            double verticalFov,
-            double aspectRatio,
-            double near,
-            double far);
-        Ray GetRay(double u, double v) const;
+            Real verticalFov,
+            Real aspectRatio,
+            Real near,
+            Real far);
+        Ray GetRay(Real u, Real v) const;
 
     private:
         Vector mOrigin;
@@ -0,0 +1,145 @@
+#include "Denoiser.h"
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#include "Trace.h"
+
+namespace hvk
+{
+    // 1D B3 spline, applied separably as the 5x5 kernel's weights
+    constexpr std::array<float, 5> kKernel = { 1.f / 16.f, 1.f / 4.f, 3.f / 8.f, 1.f / 4.f, 1.f / 16.f };
+
+    // Edge stopping strengths. The color one starts loose enough to eat 16
+    // sample noise and halves each iteration, as the taps reach further.
+    constexpr float kColorPhi = 0.5f;
+    constexpr float kNormalPower = 64.f;
+    // relative to the center pixel's depth, so it holds at any distance
+    constexpr float kDepthPhi = 0.05f;
+    constexpr float kAlbedoPhi = 0.05f;
+
+    float _DistanceSquared(const Float3& a, const Float3& b)
+    {
+        const float dx = a.x - b.x;
+        const float dy = a.y - b.y;
+        const float dz = a.z - b.z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // the G-buffer's normals are averaged over samples and may be shorter than 1
+    float _CosAngle(const Float3& a, const Float3& b)
+    {
+        const float lengths = std::sqrt((a.x * a.x + a.y * a.y + a.z * a.z) * (b.x * b.x + b.y * b.y + b.z * b.z));
+        return lengths > 0.f ? (a.x * b.x + a.y * b.y + a.z * b.z) / lengths : 0.f;
+    }
+
+    Denoiser::Denoiser(uint16_t width, uint16_t height, uint8_t numIterations)
+        : mWidth(width)
+        , mHeight(height)
+        , mNumIterations(numIterations)
+        , mScratch(width * height)
+    {
+
+    }
+
+    void Denoiser::Denoise(const GBuffer& gbuffer, std::vector<Float3>& colors, ThreadPool& pool)
+    {
+        RTX_WEEKEND_TRACE_SCOPE("Denoise");
+        float colorPhi = kColorPhi;
+        std::vector<Float3>* input = &colors;
+        std::vector<Float3>* output = &mScratch;
+        for (uint8_t iteration = 0; iteration < mNumIterations; ++iteration)
+        {
+            const int stepSize = 1 << iteration;
+            pool.ParallelFor(mHeight, 1, [&](size_t begin, size_t end) {
+                FilterRows(gbuffer, *input, *output, stepSize, colorPhi, begin, end);
+            });
+            std::swap(input, output);
+            colorPhi *= 0.5f;
+        }
+
+        // an odd number of iterations leaves the result in the scratch buffer
+        if (input != &colors)
+        {
+            colors.swap(mScratch);
+        }
+    }
+
+    void Denoiser::FilterRows(
+        const GBuffer& gbuffer,
+        const std::vector<Float3>& input,
+        std::vector<Float3>& output,
+        int stepSize,
+        float colorPhi,
+        size_t beginRow,
+        size_t endRow) const
+    {
+        const auto& depth = gbuffer.getDepth();
+        const auto& normal = gbuffer.getNormal();
+        const auto& albedo = gbuffer.getAlbedo();
+        const auto& primitiveId = gbuffer.getPrimitiveId();
+        const float inverseColorPhi = 1.f / (colorPhi * colorPhi);
+
+        for (size_t y = beginRow; y < endRow; ++y)
+        {
+            for (int x = 0; x < mWidth; ++x)
+            {
+                const size_t center = y * mWidth + x;
+                const auto& centerColor = input[center];
+                const bool centerHit = primitiveId[center] != GBuffer::kNoPrimitive;
+
+                float sumR = 0.f;
+                float sumG = 0.f;
+                float sumB = 0.f;
+                float sumWeight = 0.f;
+                for (int ky = -2; ky <= 2; ++ky)
+                {
+                    const int sy = static_cast<int>(y) + ky * stepSize;
+                    if (sy < 0 || sy >= mHeight)
+                    {
+                        continue;
+                    }
+                    for (int kx = -2; kx <= 2; ++kx)
+                    {
+                        const int sx = x + kx * stepSize;
+                        if (sx < 0 || sx >= mWidth)
+                        {
+                            continue;
+                        }
+
+                        const size_t sample = sy * mWidth + sx;
+                        const auto& sampleColor = input[sample];
+                        float weight = kKernel[ky + 2] * kKernel[kx + 2] *
+                            std::exp(-_DistanceSquared(centerColor, sampleColor) * inverseColorPhi);
+
+                        // the sky has no geometry to guide by, but never blends with it
+                        const bool sampleHit = primitiveId[sample] != GBuffer::kNoPrimitive;
+                        if (centerHit != sampleHit)
+                        {
+                            continue;
+                        }
+                        if (centerHit)
+                        {
+                            const float normalWeight = std::pow(std::max(0.f, _CosAngle(normal[center], normal[sample])), kNormalPower);
+                            const float depthDifference = std::abs(depth[center] - depth[sample]) /
+                                (kDepthPhi * depth[center] * stepSize);
+                            const float albedoDifference = _DistanceSquared(albedo[center], albedo[sample]) /
+                                (kAlbedoPhi * kAlbedoPhi);
+                            weight *= normalWeight * std::exp(-depthDifference - albedoDifference);
+                        }
+
+                        sumR += weight * sampleColor.x;
+                        sumG += weight * sampleColor.y;
+                        sumB += weight * sampleColor.z;
+                        sumWeight += weight;
+                    }
+                }
+
+                output[center] = sumWeight > 0.f ?
+                    Float3(sumR / sumWeight, sumG / sumWeight, sumB / sumWeight) :
+                    centerColor;
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef RTX_WEEKEND_DENOISER_H
+#define RTX_WEEKEND_DENOISER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Float3.h"
+#include "GBuffer.h"
+#include "ThreadPool.h"
+
+namespace hvk
+{
+    // Edge-avoiding à-trous wavelet filter. Each iteration blurs with a 5x5
+    // B3 spline kernel whose taps spread twice as far as the last one's, and
+    // weights every tap by how alike the two pixels' color, normal, depth and
+    // albedo are, so that the noise of a low sample render is smoothed away
+    // without blurring across the edges the G-buffer sees.
+    class Denoiser
+    {
+    public:
+        Denoiser(uint16_t width, uint16_t height, uint8_t numIterations);
+
+        // Filters colors in place, guided by gbuffer, which must be the same
+        // size. Every iteration runs its scanlines in parallel on pool.
+        void Denoise(const GBuffer& gbuffer, std::vector<Float3>& colors, ThreadPool& pool);
+
+    private:
+        void FilterRows(
+            const GBuffer& gbuffer,
+            const std::vector<Float3>& input,
+            std::vector<Float3>& output,
+            int stepSize,
+            float colorPhi,
+            size_t beginRow,
+            size_t endRow) const;
+
+        uint16_t mWidth;
+        uint16_t mHeight;
+        uint8_t mNumIterations;
+        std::vector<Float3> mScratch;
+    };
+}
+
+#endif //RTX_WEEKEND_DENOISER_H
@@ -0,0 +1,48 @@
+#include "Disc.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace hvk
+{
+    Disc::Disc(const Vector& center, const Vector& normal, float radius)
+        : mCenter(center)
+        , mNormal(normal.Normalized())
+        , mRadius(radius)
+    {
+    }
+
+    Disc::Disc()
+        : mCenter()
+        , mNormal(0.f, 1.f, 0.f)
+        , mRadius(0.f)
+    {
+    }
+
+    Vector Disc::getCenter() const
+    {
+        return mCenter.Load();
+    }
+
+    Vector Disc::getNormal() const
+    {
+        return mNormal.Load();
+    }
+
+    float Disc::getRadius() const
+    {
+        return mRadius;
+    }
+
+    AABB Disc::getBounds() const
+    {
+        // the disc extends along each axis by r * sin of the angle between
+        // that axis and the normal, i.e. r * sqrt(1 - n_i^2)
+        const auto extent = [&](float n) {
+            return mRadius * sqrt(std::max(0.f, 1.f - n * n)) + 1e-4f;
+        };
+        const Vector halfExtent(extent(mNormal.x), extent(mNormal.y), extent(mNormal.z));
+        const auto center = mCenter.Load();
+        return AABB(center - halfExtent, center + halfExtent);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef RTX_WEEKEND_DISC_H
+#define RTX_WEEKEND_DISC_H
+
+#include "Vector.h"
+#include "AABB.h"
+#include "Float3.h"
+
+namespace hvk
+{
+    // Bounded circular patch of a plane, a finite alternative to Plane that
+    // can be placed in a BVH.
+    class Disc
+    {
+    public:
+        Disc(const Vector& center, const Vector& normal, float radius);
+        Disc();
+
+        Vector getCenter() const;
+        Vector getNormal() const;
+        float getRadius() const;
+        AABB getBounds() const;
+
+    private:
+        Float3 mCenter;
+        Float3 mNormal;
+        float mRadius;
+    };
+}
+
+#endif //RTX_WEEKEND_DISC_H
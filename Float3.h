@@ -0,0 +1,37 @@
+#ifndef RTX_WEEKEND_FLOAT3_H
+#define RTX_WEEKEND_FLOAT3_H
+
+#include <type_traits>
+
+#include "Vector.h"
+
+namespace hvk
+{
+    // Packed storage for three floats. Vector keeps the 16 byte SIMD register
+    // layout that the math wants, which wastes a quarter of every stored
+    // position, normal, color or bound. Scene data and framebuffers hold a
+    // Float3 instead and load it into a Vector to compute with.
+    struct Float3 : public XMFLOAT3
+    {
+        Float3()
+            : XMFLOAT3(0.f, 0.f, 0.f)
+        {}
+        Float3(float x, float y, float z)
+            : XMFLOAT3(x, y, z)
+        {}
+        explicit Float3(const Vector& v)
+        {
+            XMStoreFloat3(this, v.getNativeVec());
+        }
+
+        Vector Load() const
+        {
+            return Vector(XMLoadFloat3(this));
+        }
+    };
+
+    static_assert(sizeof(Float3) == 3 * sizeof(float));
+    static_assert(std::is_trivially_copyable_v<Float3>);
+}
+
+#endif //RTX_WEEKEND_FLOAT3_H
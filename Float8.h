@@ -0,0 +1,139 @@
+#ifndef RTX_WEEKEND_FLOAT8_H
+#define RTX_WEEKEND_FLOAT8_H
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+
+namespace hvk
+{
+    // Eight floats in one AVX register, one per SPMD lane. Comparisons return
+    // a Float8 whose lanes are all ones or all zeros, to be used with Select.
+    struct Float8
+    {
+        __m256 v;
+
+        Float8() : v(_mm256_setzero_ps()) {}
+        Float8(float f) : v(_mm256_set1_ps(f)) {}
+        explicit Float8(__m256 m) : v(m) {}
+
+        static Float8 Load(const std::array<float, 8>& a) { return Float8(_mm256_loadu_ps(a.data())); }
+        void Store(std::array<float, 8>& a) const { _mm256_storeu_ps(a.data(), v); }
+
+        Float8 operator+ (const Float8& rhs) const { return Float8(_mm256_add_ps(v, rhs.v)); }
+        Float8 operator- (const Float8& rhs) const { return Float8(_mm256_sub_ps(v, rhs.v)); }
+        Float8 operator* (const Float8& rhs) const { return Float8(_mm256_mul_ps(v, rhs.v)); }
+        Float8 operator/ (const Float8& rhs) const { return Float8(_mm256_div_ps(v, rhs.v)); }
+        Float8 operator- () const { return Float8(_mm256_xor_ps(v, _mm256_set1_ps(-0.f))); }
+
+        Float8 operator< (const Float8& rhs) const { return Float8(_mm256_cmp_ps(v, rhs.v, _CMP_LT_OQ)); }
+        Float8 operator> (const Float8& rhs) const { return Float8(_mm256_cmp_ps(v, rhs.v, _CMP_GT_OQ)); }
+        Float8 operator& (const Float8& rhs) const { return Float8(_mm256_and_ps(v, rhs.v)); }
+        Float8 operator| (const Float8& rhs) const { return Float8(_mm256_or_ps(v, rhs.v)); }
+        // lanes of this mask that are not set in rhs
+        Float8 AndNot(const Float8& rhs) const { return Float8(_mm256_andnot_ps(rhs.v, v)); }
+
+        // one bit per lane of a comparison result
+        uint32_t MoveMask() const { return static_cast<uint32_t>(_mm256_movemask_ps(v)); }
+
+        static Float8 FromMask(uint32_t mask)
+        {
+            const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            const __m256i selected = _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(mask)), bits);
+            return Float8(_mm256_castsi256_ps(_mm256_cmpeq_epi32(selected, bits)));
+        }
+
+        // picks a where mask is set and b elsewhere
+        static Float8 Select(const Float8& mask, const Float8& a, const Float8& b)
+        {
+            return Float8(_mm256_blendv_ps(b.v, a.v, mask.v));
+        }
+
+        static Float8 Sqrt(const Float8& f) { return Float8(_mm256_sqrt_ps(f.v)); }
+        static Float8 Abs(const Float8& f) { return Float8(_mm256_andnot_ps(_mm256_set1_ps(-0.f), f.v)); }
+        static Float8 Min(const Float8& a, const Float8& b) { return Float8(_mm256_min_ps(a.v, b.v)); }
+        static Float8 Max(const Float8& a, const Float8& b) { return Float8(_mm256_max_ps(a.v, b.v)); }
+
+        // sine and cosine of angles in [-pi, pi], good to about 1e-7
+        static void SinCos(const Float8& angle, Float8& outSin, Float8& outCos)
+        {
+            // fold into [-pi/2, pi/2], where sin keeps its value and cos flips sign
+            const Float8 halfPi(1.57079632679f);
+            const Float8 pi(3.14159265359f);
+            const auto high = angle > halfPi;
+            const auto low = angle < -halfPi;
+            const auto folded = Select(high, pi - angle, Select(low, -pi - angle, angle));
+            const auto cosSign = Select(high | low, Float8(-1.f), Float8(1.f));
+
+            const auto x2 = folded * folded;
+            outSin = folded * (Float8(1.f) + x2 * (Float8(-1.f / 6.f) + x2 * (Float8(1.f / 120.f) +
+                x2 * (Float8(-1.f / 5040.f) + x2 * (Float8(1.f / 362880.f) + x2 * Float8(-1.f / 39916800.f))))));
+            outCos = cosSign * (Float8(1.f) + x2 * (Float8(-1.f / 2.f) + x2 * (Float8(1.f / 24.f) +
+                x2 * (Float8(-1.f / 720.f) + x2 * (Float8(1.f / 40320.f) + x2 * (Float8(-1.f / 3628800.f) +
+                x2 * Float8(1.f / 479001600.f)))))));
+        }
+    };
+
+    // a 3 component vector per lane, stored as structure of arrays
+    struct Vector8
+    {
+        Float8 x;
+        Float8 y;
+        Float8 z;
+
+        Vector8 operator+ (const Vector8& rhs) const { return { x + rhs.x, y + rhs.y, z + rhs.z }; }
+        Vector8 operator- (const Vector8& rhs) const { return { x - rhs.x, y - rhs.y, z - rhs.z }; }
+        Vector8 operator* (const Vector8& rhs) const { return { x * rhs.x, y * rhs.y, z * rhs.z }; }
+        Vector8 operator* (const Float8& rhs) const { return { x * rhs, y * rhs, z * rhs }; }
+
+        static Float8 Dot(const Vector8& lhs, const Vector8& rhs)
+        {
+            return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+        }
+
+        Vector8 Normalized() const
+        {
+            return *this * (Float8(1.f) / Float8::Sqrt(Dot(*this, *this)));
+        }
+
+        static Vector8 Reflect(const Vector8& v, const Vector8& normal)
+        {
+            return v - normal * (Float8(2.f) * Dot(v, normal));
+        }
+
+        static Vector8 Select(const Float8& mask, const Vector8& a, const Vector8& b)
+        {
+            return { Float8::Select(mask, a.x, b.x), Float8::Select(mask, a.y, b.y), Float8::Select(mask, a.z, b.z) };
+        }
+    };
+
+    // an independent xorshift generator per lane, seeds must not be 0
+    class Random8
+    {
+    public:
+        explicit Random8(const std::array<uint32_t, 8>& seeds)
+            : mState(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(seeds.data())))
+        {}
+
+        // uniform in [0, 1)
+        Float8 Next()
+        {
+            mState = _mm256_xor_si256(mState, _mm256_slli_epi32(mState, 13));
+            mState = _mm256_xor_si256(mState, _mm256_srli_epi32(mState, 17));
+            mState = _mm256_xor_si256(mState, _mm256_slli_epi32(mState, 5));
+            // top 24 bits scaled to [0, 1)
+            const __m256i mantissa = _mm256_srli_epi32(mState, 8);
+            return Float8(_mm256_mul_ps(_mm256_cvtepi32_ps(mantissa), _mm256_set1_ps(1.f / 16777216.f)));
+        }
+
+    private:
+        __m256i mState;
+    };
+}
+
+#endif
+
+#endif //RTX_WEEKEND_FLOAT8_H
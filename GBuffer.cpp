@@ -0,0 +1,127 @@
+#include "GBuffer.h"
+
+#include <array>
+#include <optional>
+#include <algorithm>
+
+#include "RayPacket.h"
+#include "math.h"
+#include "Trace.h"
+
+namespace hvk
+{
+    // primary rays are traced in packets of this many samples of the same pixel
+    constexpr size_t kGBufferPacketSize = 8;
+
+    GBuffer::GBuffer(uint16_t width, uint16_t height)
+        : mWidth(width)
+        , mHeight(height)
+        , mDepth(width * height, 0.f)
+        , mNormal(width * height)
+        , mAlbedo(width * height)
+        , mPosition(width * height)
+        , mPrimitiveId(width * height, kNoPrimitive)
+    {
+
+    }
+
+    void GBuffer::Render(const Scene& scene, const Camera& camera, uint16_t samplesPerPixel, ThreadPool& pool)
+    {
+        RTX_WEEKEND_TRACE_SCOPE("G-buffer");
+        for (int i = mHeight - 1; i >= 0; --i)
+        {
+            pool.QueueWork([&, i]()
+            {
+                for (int j = 0; j < mWidth; ++j)
+                {
+                    double depth = 0.0;
+                    Vector normal(0.f, 0.f, 0.f);
+                    Vector albedo(0.f, 0.f, 0.f);
+                    Vector position(0.f, 0.f, 0.f);
+                    uint32_t primitiveId = kNoPrimitive;
+                    uint16_t numHits = 0;
+
+                    for (size_t s = 0; s < samplesPerPixel; s += kGBufferPacketSize)
+                    {
+                        RayPacket<kGBufferPacketSize> packet;
+                        const size_t numLanes = std::min<size_t>(kGBufferPacketSize, samplesPerPixel - s);
+                        for (size_t lane = 0; lane < numLanes; ++lane)
+                        {
+                            auto u = static_cast<Real>(j + math::getRandom<Real, Real(0), Real(1)>()) / (mWidth - 1);
+                            auto v = static_cast<Real>(i + math::getRandom<Real, Real(0), Real(1)>()) / (mHeight - 1);
+                            packet.Set(lane, camera.GetRay(u, v));
+                        }
+
+                        std::array<std::optional<SceneHit>, kGBufferPacketSize> hits;
+                        scene.IntersectPacket(packet, hits);
+                        for (size_t lane = 0; lane < numLanes; ++lane)
+                        {
+                            if (!hits[lane].has_value())
+                            {
+                                continue;
+                            }
+
+                            const auto& record = hits[lane]->record;
+                            depth += record.t;
+                            normal += record.normal.Normalized();
+                            albedo += hits[lane]->material->getAlbedo();
+                            position += record.point;
+                            if (primitiveId == kNoPrimitive)
+                            {
+                                primitiveId = hits[lane]->primitiveId;
+                            }
+                            ++numHits;
+                        }
+                    }
+
+                    const size_t writeIndex = ((mHeight - 1) - i) * mWidth + j;
+                    mPrimitiveId[writeIndex] = primitiveId;
+                    if (numHits > 0)
+                    {
+                        const float inverseHits = 1.f / numHits;
+                        mDepth[writeIndex] = static_cast<float>(depth * inverseHits);
+                        mNormal[writeIndex] = Float3(normal * inverseHits);
+                        mAlbedo[writeIndex] = Float3(albedo * inverseHits);
+                        mPosition[writeIndex] = Float3(position * inverseHits);
+                    }
+                }
+            });
+        }
+        pool.Wait();
+    }
+
+    uint16_t GBuffer::getWidth() const
+    {
+        return mWidth;
+    }
+
+    uint16_t GBuffer::getHeight() const
+    {
+        return mHeight;
+    }
+
+    const std::vector<float>& GBuffer::getDepth() const
+    {
+        return mDepth;
+    }
+
+    const std::vector<Float3>& GBuffer::getNormal() const
+    {
+        return mNormal;
+    }
+
+    const std::vector<Float3>& GBuffer::getAlbedo() const
+    {
+        return mAlbedo;
+    }
+
+    const std::vector<Float3>& GBuffer::getPosition() const
+    {
+        return mPosition;
+    }
+
+    const std::vector<uint32_t>& GBuffer::getPrimitiveId() const
+    {
+        return mPrimitiveId;
+    }
+}
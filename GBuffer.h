@@ -0,0 +1,54 @@
+#ifndef RTX_WEEKEND_GBUFFER_H
+#define RTX_WEEKEND_GBUFFER_H
+
+#include <cstdint>
+#include <vector>
+#include <limits>
+
+#include "Float3.h"
+#include "Camera.h"
+#include "Scene.h"
+#include "ThreadPool.h"
+
+namespace hvk
+{
+    // First hit attributes of every pixel, traced in a pass of their own so
+    // they can use far fewer samples than the beauty render. Each buffer is
+    // row major with the top scanline first, like the image written out.
+    class GBuffer
+    {
+    public:
+        // primitive id of pixels whose samples all miss
+        static constexpr uint32_t kNoPrimitive = std::numeric_limits<uint32_t>::max();
+
+        GBuffer(uint16_t width, uint16_t height);
+
+        // Traces samplesPerPixel primary rays per pixel, one task per scanline.
+        // Depth, normal, albedo and position are averaged over the samples that
+        // hit and stay zero where none do. The primitive id is that of the
+        // first sample to hit, see SceneHit::primitiveId.
+        void Render(const Scene& scene, const Camera& camera, uint16_t samplesPerPixel, ThreadPool& pool);
+
+        uint16_t getWidth() const;
+        uint16_t getHeight() const;
+        // distance along the primary ray
+        const std::vector<float>& getDepth() const;
+        // world space, unit length before averaging
+        const std::vector<Float3>& getNormal() const;
+        const std::vector<Float3>& getAlbedo() const;
+        // world space hit point
+        const std::vector<Float3>& getPosition() const;
+        const std::vector<uint32_t>& getPrimitiveId() const;
+
+    private:
+        uint16_t mWidth;
+        uint16_t mHeight;
+        std::vector<float> mDepth;
+        std::vector<Float3> mNormal;
+        std::vector<Float3> mAlbedo;
+        std::vector<Float3> mPosition;
+        std::vector<uint32_t> mPrimitiveId;
+    };
+}
+
+#endif //RTX_WEEKEND_GBUFFER_H
@@ -0,0 +1,291 @@
+#include "Geometry.h"
+
+#include "hittest.h"
+#include "Hash.h"
+#include "Trace.h"
+
+namespace hvk
+{
+    Geometry::Geometry()
+        : mSpheres()
+        , mBoxes()
+        , mQuads()
+        , mDiscs()
+        , mPrimitives()
+        , mMaterialIds()
+        , mMaterials()
+        , mPrimitiveBounds()
+        , mDirtyPrimitives()
+        , mBVH()
+    {
+    }
+
+    uint32_t Geometry::AddSphere(const Sphere& sphere, const Material& material)
+    {
+        mPrimitives.push_back(PrimitiveRef{ PrimitiveType::Sphere, static_cast<uint32_t>(mSpheres.size()) });
+        mSpheres.push_back(sphere);
+        mMaterialIds.push_back(mMaterials.Add(material));
+        return static_cast<uint32_t>(mPrimitives.size() - 1);
+    }
+
+    uint32_t Geometry::AddBox(const Box& box, const Material& material)
+    {
+        mPrimitives.push_back(PrimitiveRef{ PrimitiveType::Box, static_cast<uint32_t>(mBoxes.size()) });
+        mBoxes.push_back(box);
+        mMaterialIds.push_back(mMaterials.Add(material));
+        return static_cast<uint32_t>(mPrimitives.size() - 1);
+    }
+
+    uint32_t Geometry::AddQuad(const Quad& quad, const Material& material)
+    {
+        mPrimitives.push_back(PrimitiveRef{ PrimitiveType::Quad, static_cast<uint32_t>(mQuads.size()) });
+        mQuads.push_back(quad);
+        mMaterialIds.push_back(mMaterials.Add(material));
+        return static_cast<uint32_t>(mPrimitives.size() - 1);
+    }
+
+    uint32_t Geometry::AddDisc(const Disc& disc, const Material& material)
+    {
+        mPrimitives.push_back(PrimitiveRef{ PrimitiveType::Disc, static_cast<uint32_t>(mDiscs.size()) });
+        mDiscs.push_back(disc);
+        mMaterialIds.push_back(mMaterials.Add(material));
+        return static_cast<uint32_t>(mPrimitives.size() - 1);
+    }
+
+    void Geometry::Build(ThreadPool* pool, BVHBuildQuality quality)
+    {
+        RTX_WEEKEND_TRACE_SCOPE("BVH build");
+        mPrimitiveBounds.clear();
+        mPrimitiveBounds.reserve(mPrimitives.size());
+        for (const auto& primitive : mPrimitives)
+        {
+            mPrimitiveBounds.push_back(GetPrimitiveBounds(primitive));
+        }
+        mDirtyPrimitives.clear();
+        mBVH.Build(mPrimitiveBounds, pool, quality);
+    }
+
+    void Geometry::SetSphere(uint32_t primitive, const Sphere& sphere)
+    {
+        const auto& ref = mPrimitives[primitive];
+        if (ref.type != PrimitiveType::Sphere)
+        {
+            return;
+        }
+        mSpheres[ref.index] = sphere;
+        mDirtyPrimitives.push_back(primitive);
+    }
+
+    void Geometry::SetBox(uint32_t primitive, const Box& box)
+    {
+        const auto& ref = mPrimitives[primitive];
+        if (ref.type != PrimitiveType::Box)
+        {
+            return;
+        }
+        mBoxes[ref.index] = box;
+        mDirtyPrimitives.push_back(primitive);
+    }
+
+    void Geometry::SetQuad(uint32_t primitive, const Quad& quad)
+    {
+        const auto& ref = mPrimitives[primitive];
+        if (ref.type != PrimitiveType::Quad)
+        {
+            return;
+        }
+        mQuads[ref.index] = quad;
+        mDirtyPrimitives.push_back(primitive);
+    }
+
+    void Geometry::SetDisc(uint32_t primitive, const Disc& disc)
+    {
+        const auto& ref = mPrimitives[primitive];
+        if (ref.type != PrimitiveType::Disc)
+        {
+            return;
+        }
+        mDiscs[ref.index] = disc;
+        mDirtyPrimitives.push_back(primitive);
+    }
+
+    void Geometry::SetMaterial(uint32_t primitive, const Material& material)
+    {
+        // add first, so that setting the same material never frees its slot
+        const MaterialId previous = mMaterialIds[primitive];
+        mMaterialIds[primitive] = mMaterials.Add(material);
+        mMaterials.Release(previous);
+    }
+
+    void Geometry::Refit()
+    {
+        for (const auto primitive : mDirtyPrimitives)
+        {
+            mPrimitiveBounds[primitive] = GetPrimitiveBounds(mPrimitives[primitive]);
+        }
+        mBVH.Refit(mDirtyPrimitives, mPrimitiveBounds);
+        mDirtyPrimitives.clear();
+    }
+
+    size_t Geometry::getNumPrimitives() const
+    {
+        return mPrimitives.size();
+    }
+
+    AABB Geometry::getBounds() const
+    {
+        return mBVH.getBounds();
+    }
+
+    float Geometry::getSAHCost() const
+    {
+        return mBVH.getSAHCost();
+    }
+
+    uint64_t Geometry::getHash() const
+    {
+        uint64_t hash = hash::kFnvOffset;
+        for (size_t i = 0; i < mPrimitives.size(); ++i)
+        {
+            const auto bounds = GetPrimitiveBounds(mPrimitives[i]);
+            const auto& material = mMaterials.Get(mMaterialIds[i]);
+            hash = hash::Combine(hash, static_cast<uint32_t>(mPrimitives[i].type));
+            hash = hash::Combine(hash, bounds.getMin());
+            hash = hash::Combine(hash, bounds.getMax());
+            hash = hash::Combine(hash, static_cast<uint32_t>(material.getType()));
+            hash = hash::Combine(hash, material.getAlbedo());
+            hash = hash::Combine(hash, static_cast<float>(material.getIOR()));
+        }
+        return hash;
+    }
+
+    AABB Geometry::GetPrimitiveBounds(const PrimitiveRef& primitive) const
+    {
+        switch (primitive.type)
+        {
+            case PrimitiveType::Sphere:
+                return mSpheres[primitive.index].getBounds();
+            case PrimitiveType::Box:
+                return mBoxes[primitive.index].getBounds();
+            case PrimitiveType::Quad:
+                return mQuads[primitive.index].getBounds();
+            case PrimitiveType::Disc:
+                return mDiscs[primitive.index].getBounds();
+        }
+        return AABB();
+    }
+
+    bool Geometry::IntersectPrimitive(const PrimitiveRef& primitive, const Ray& ray, float tMax, HitRecord& outRecord) const
+    {
+        if (primitive.type == PrimitiveType::Sphere)
+        {
+            const auto& sphere = mSpheres[primitive.index];
+            auto intersection = hit::SphereRayIntersect(sphere, ray);
+            if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < tMax)
+            {
+                outRecord.t = intersection.value();
+                outRecord.point = ray.PointAt(outRecord.t);
+                outRecord.normal = (outRecord.point - sphere.getCenter()).Normalized();
+                return true;
+            }
+        }
+        else if (primitive.type == PrimitiveType::Box)
+        {
+            const auto& box = mBoxes[primitive.index];
+            auto intersection = hit::BoxRayIntersect(box, ray);
+            if (intersection.has_value() && intersection.value().second > 0.f && intersection.value().second < tMax)
+            {
+                outRecord.t = intersection.value().second;
+                outRecord.point = ray.PointAt(outRecord.t);
+                outRecord.normal = box.getSide(intersection.value().first).getDirection().Normalized();
+                return true;
+            }
+        }
+        else if (primitive.type == PrimitiveType::Quad)
+        {
+            const auto& quad = mQuads[primitive.index];
+            auto intersection = hit::QuadRayIntersect(quad, ray);
+            if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < tMax)
+            {
+                outRecord.t = intersection.value();
+                outRecord.point = ray.PointAt(outRecord.t);
+                outRecord.normal = quad.getNormal();
+                return true;
+            }
+        }
+        else if (primitive.type == PrimitiveType::Disc)
+        {
+            const auto& disc = mDiscs[primitive.index];
+            auto intersection = hit::DiscRayIntersect(disc, ray);
+            if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < tMax)
+            {
+                outRecord.t = intersection.value();
+                outRecord.point = ray.PointAt(outRecord.t);
+                outRecord.normal = disc.getNormal();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Geometry::Intersect(
+        const Ray& ray,
+        float& tMax,
+        HitRecord& outRecord,
+        const Material*& outMaterial,
+        uint32_t& outPrimitive) const
+    {
+        bool hitAny = false;
+        mBVH.Intersect(ray, tMax, [&](uint32_t primitiveIndex, float& closest) {
+            if (IntersectPrimitive(mPrimitives[primitiveIndex], ray, closest, outRecord))
+            {
+                closest = static_cast<float>(outRecord.t);
+                outMaterial = &mMaterials.Get(mMaterialIds[primitiveIndex]);
+                outPrimitive = primitiveIndex;
+                hitAny = true;
+            }
+        });
+        return hitAny;
+    }
+
+    template <size_t N>
+    void Geometry::IntersectPacket(
+        const RayPacket<N>& packet,
+        typename RayPacket<N>::Mask mask,
+        std::array<float, N>& tMax,
+        std::array<HitRecord, N>& outRecords,
+        std::array<const Material*, N>& outMaterials,
+        std::array<uint32_t, N>& outPrimitives) const
+    {
+        using Mask = typename RayPacket<N>::Mask;
+        mBVH.IntersectPacket(packet, mask, tMax, [&](uint32_t primitiveIndex, Mask lanes, std::array<float, N>& closest) {
+            const auto& primitive = mPrimitives[primitiveIndex];
+            for (size_t lane = 0; lane < N; ++lane)
+            {
+                if ((lanes & (Mask(1) << lane)) == 0)
+                {
+                    continue;
+                }
+                if (IntersectPrimitive(primitive, packet.GetRay(lane), closest[lane], outRecords[lane]))
+                {
+                    closest[lane] = static_cast<float>(outRecords[lane].t);
+                    outMaterials[lane] = &mMaterials.Get(mMaterialIds[primitiveIndex]);
+                    outPrimitives[lane] = primitiveIndex;
+                }
+            }
+        });
+    }
+
+    template void Geometry::IntersectPacket<4>(
+        const RayPacket<4>&, RayPacket<4>::Mask, std::array<float, 4>&,
+        std::array<HitRecord, 4>&, std::array<const Material*, 4>&,
+        std::array<uint32_t, 4>&) const;
+    template void Geometry::IntersectPacket<8>(
+        const RayPacket<8>&, RayPacket<8>::Mask, std::array<float, 8>&,
+        std::array<HitRecord, 8>&, std::array<const Material*, 8>&,
+        std::array<uint32_t, 8>&) const;
+    template void Geometry::IntersectPacket<16>(
+        const RayPacket<16>&, RayPacket<16>::Mask, std::array<float, 16>&,
+        std::array<HitRecord, 16>&, std::array<const Material*, 16>&,
+        std::array<uint32_t, 16>&) const;
+}
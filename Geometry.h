@@ -0,0 +1,105 @@
+#ifndef RTX_WEEKEND_GEOMETRY_H
+#define RTX_WEEKEND_GEOMETRY_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Ray.h"
+#include "Sphere.h"
+#include "Box.h"
+#include "Quad.h"
+#include "Disc.h"
+#include "Material.h"
+#include "MaterialTable.h"
+#include "HitRecord.h"
+#include "BVH.h"
+#include "ThreadPool.h"
+#include "RayPacket.h"
+
+namespace hvk
+{
+    enum class PrimitiveType : uint8_t
+    {
+        Sphere,
+        Box,
+        Quad,
+        Disc
+    };
+
+    struct PrimitiveRef
+    {
+        PrimitiveType type;
+        // index into the array of primitives of this type
+        uint32_t index;
+    };
+
+    // A set of primitives along with their bottom level BVH. Geometry is
+    // built once and may be shared by any number of Instances, so memory
+    // scales with the unique geometry rather than the number of copies.
+    class Geometry
+    {
+    public:
+        Geometry();
+
+        uint32_t AddSphere(const Sphere& sphere, const Material& material);
+        uint32_t AddBox(const Box& box, const Material& material);
+        uint32_t AddQuad(const Quad& quad, const Material& material);
+        uint32_t AddDisc(const Disc& disc, const Material& material);
+
+        void Build(ThreadPool* pool = nullptr, BVHBuildQuality quality = BVHBuildQuality::High);
+
+        // Replace an existing primitive in place. The BVH is not touched until
+        // Refit or Build is called.
+        void SetSphere(uint32_t primitive, const Sphere& sphere);
+        void SetBox(uint32_t primitive, const Box& box);
+        void SetQuad(uint32_t primitive, const Quad& quad);
+        void SetDisc(uint32_t primitive, const Disc& disc);
+        void SetMaterial(uint32_t primitive, const Material& material);
+
+        // refits the BVH around primitives changed since the last Build or Refit
+        void Refit();
+
+        size_t getNumPrimitives() const;
+        AABB getBounds() const;
+        float getSAHCost() const;
+        // of every primitive's type, bounds and material, see hash::Combine
+        uint64_t getHash() const;
+
+        // finds the closest hit closer than tMax, lowering tMax to it.
+        // outPrimitive is the index the hit primitive's Add call returned.
+        bool Intersect(
+            const Ray& ray,
+            float& tMax,
+            HitRecord& outRecord,
+            const Material*& outMaterial,
+            uint32_t& outPrimitive) const;
+        // same as Intersect for each lane in mask, sharing the BVH traversal
+        template <size_t N>
+        void IntersectPacket(
+            const RayPacket<N>& packet,
+            typename RayPacket<N>::Mask mask,
+            std::array<float, N>& tMax,
+            std::array<HitRecord, N>& outRecords,
+            std::array<const Material*, N>& outMaterials,
+            std::array<uint32_t, N>& outPrimitives) const;
+
+    private:
+        AABB GetPrimitiveBounds(const PrimitiveRef& primitive) const;
+        bool IntersectPrimitive(const PrimitiveRef& primitive, const Ray& ray, float tMax, HitRecord& outRecord) const;
+
+        std::vector<Sphere> mSpheres;
+        std::vector<Box> mBoxes;
+        std::vector<Quad> mQuads;
+        std::vector<Disc> mDiscs;
+        std::vector<PrimitiveRef> mPrimitives;
+        // material of each primitive, by id into mMaterials
+        std::vector<MaterialId> mMaterialIds;
+        MaterialTable mMaterials;
+        std::vector<AABB> mPrimitiveBounds;
+        std::vector<uint32_t> mDirtyPrimitives;
+        BVH mBVH;
+    };
+}
+
+#endif //RTX_WEEKEND_GEOMETRY_H
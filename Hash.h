@@ -0,0 +1,47 @@
+#ifndef RTX_WEEKEND_HASH_H
+#define RTX_WEEKEND_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Vector.h"
+
+namespace hvk
+{
+    namespace hash
+    {
+        // FNV-1a, which unlike std::hash is the same on every platform, so
+        // hashes can be compared between processes and machines
+        constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+        constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+        inline uint64_t Combine(uint64_t hash, const void* data, size_t size)
+        {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash = (hash ^ bytes[i]) * kFnvPrime;
+            }
+            return hash;
+        }
+
+        inline uint64_t Combine(uint64_t hash, float value)
+        {
+            return Combine(hash, &value, sizeof(value));
+        }
+
+        inline uint64_t Combine(uint64_t hash, uint32_t value)
+        {
+            return Combine(hash, &value, sizeof(value));
+        }
+
+        inline uint64_t Combine(uint64_t hash, const Vector& value)
+        {
+            hash = Combine(hash, value.X());
+            hash = Combine(hash, value.Y());
+            return Combine(hash, value.Z());
+        }
+    }
+}
+
+#endif //RTX_WEEKEND_HASH_H
@@ -2,6 +2,7 @@
 #define RTX_WEEKEND_HITRECORD_H
 
 #include "Vector.h"
+#include "Real.h"
 
 namespace  hvk
 {
@@ -9,7 +10,7 @@ namespace  hvk
     {
         Vector point;
         Vector normal;
-        double t;
+        Real t;
         bool frontFace;
     };
 }
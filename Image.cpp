@@ -0,0 +1,106 @@
+#include "Image.h"
+
+#include <algorithm>
+#include <string>
+
+namespace hvk
+{
+    void _WriteColor(std::ostream& out, const Float3& c)
+    {
+        auto ir = static_cast<int>(255.999 * c.x);
+        auto ig = static_cast<int>(255.999 * c.y);
+        auto ib = static_cast<int>(255.999 * c.z);
+
+        out << ir << ' ' << ig << ' ' << ib << '\n';
+    }
+
+    void WriteImage(std::ostream& out, const std::vector<Float3>& colors, uint16_t width, uint16_t height)
+    {
+        out << "P3\n" << width << ' ' << height << "\n255\n";
+        for (const auto& c : colors)
+        {
+            _WriteColor(out, c);
+        }
+        out.flush();
+    }
+
+    // the next number of a PPM header, skipping whitespace and comments
+    std::optional<uint32_t> _ReadHeaderNumber(std::istream& in)
+    {
+        while (true)
+        {
+            in >> std::ws;
+            if (in.peek() != '#')
+            {
+                break;
+            }
+            std::string comment;
+            std::getline(in, comment);
+        }
+        uint32_t value = 0;
+        if (!(in >> value))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    std::optional<Image> ReadImage(std::istream& in)
+    {
+        std::string magic;
+        in >> magic;
+        if (magic != "P3" && magic != "P6")
+        {
+            return std::nullopt;
+        }
+
+        const auto width = _ReadHeaderNumber(in);
+        const auto height = _ReadHeaderNumber(in);
+        const auto maxValue = _ReadHeaderNumber(in);
+        if (!width.has_value() || !height.has_value() || !maxValue.has_value() ||
+            width.value() == 0 || width.value() > UINT16_MAX || height.value() == 0 || height.value() > UINT16_MAX ||
+            maxValue.value() == 0 || maxValue.value() > 255)
+        {
+            return std::nullopt;
+        }
+
+        Image image = { static_cast<uint16_t>(width.value()), static_cast<uint16_t>(height.value()), {} };
+        image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+        const float scale = 1.f / static_cast<float>(maxValue.value());
+        if (magic == "P3")
+        {
+            for (auto& pixel : image.pixels)
+            {
+                uint32_t r = 0, g = 0, b = 0;
+                if (!(in >> r >> g >> b))
+                {
+                    return std::nullopt;
+                }
+                pixel = Float3(r * scale, g * scale, b * scale);
+            }
+        }
+        else
+        {
+            // a single whitespace character separates the header from the samples
+            in.get();
+            for (auto& pixel : image.pixels)
+            {
+                unsigned char rgb[3];
+                if (!in.read(reinterpret_cast<char*>(rgb), sizeof(rgb)))
+                {
+                    return std::nullopt;
+                }
+                pixel = Float3(rgb[0] * scale, rgb[1] * scale, rgb[2] * scale);
+            }
+        }
+        return image;
+    }
+
+    Float3 HeatColor(float t)
+    {
+        return Float3(
+            std::clamp(3.f * t, 0.f, 1.f),
+            std::clamp(3.f * t - 1.f, 0.f, 1.f),
+            std::clamp(3.f * t - 2.f, 0.f, 1.f));
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef RTX_WEEKEND_IMAGE_H
+#define RTX_WEEKEND_IMAGE_H
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "Float3.h"
+
+namespace hvk
+{
+    // An image as rtx_weekend writes it, rows top down, channels in [0, 1]
+    struct Image
+    {
+        uint16_t width;
+        uint16_t height;
+        std::vector<Float3> pixels;
+    };
+
+    // Writes colors as a plain (P3) PPM, 8 bits per channel
+    void WriteImage(std::ostream& out, const std::vector<Float3>& colors, uint16_t width, uint16_t height);
+
+    // Reads a plain (P3) or binary (P6) PPM with 8 bits per channel. Returns
+    // nullopt if in does not hold one.
+    std::optional<Image> ReadImage(std::istream& in);
+
+    // the heatmap ramp: black through red and yellow to white as t goes from
+    // 0 to 1, clamped outside
+    Float3 HeatColor(float t);
+}
+
+#endif //RTX_WEEKEND_IMAGE_H
@@ -0,0 +1,90 @@
+#include "ImageMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace hvk
+{
+    // error over the pixels [x0, x1) x [y0, y1), sizes already checked
+    ImageError _CompareRegion(const Image& image, const Image& reference, size_t x0, size_t y0, size_t x1, size_t y1)
+    {
+        double squared = 0.0;
+        double relative = 0.0;
+        for (size_t y = y0; y < y1; ++y)
+        {
+            for (size_t x = x0; x < x1; ++x)
+            {
+                const size_t pixel = y * image.width + x;
+                const float a[3] = { image.pixels[pixel].x, image.pixels[pixel].y, image.pixels[pixel].z };
+                const float b[3] = { reference.pixels[pixel].x, reference.pixels[pixel].y, reference.pixels[pixel].z };
+                for (size_t channel = 0; channel < 3; ++channel)
+                {
+                    const double difference = static_cast<double>(a[channel]) - b[channel];
+                    squared += difference * difference;
+                    relative += difference * difference / (static_cast<double>(b[channel]) * b[channel] + kRelativeMSEEpsilon);
+                }
+            }
+        }
+
+        const double numSamples = 3.0 * (x1 - x0) * (y1 - y0);
+        const double mse = squared / numSamples;
+        return {
+            std::sqrt(mse),
+            relative / numSamples,
+            mse > 0.0 ? -10.0 * std::log10(mse) : std::numeric_limits<double>::infinity()
+        };
+    }
+
+    bool _SameSize(const Image& image, const Image& reference)
+    {
+        return image.width == reference.width && image.height == reference.height && !image.pixels.empty() &&
+            image.pixels.size() == reference.pixels.size();
+    }
+
+    std::optional<ImageError> CompareImages(const Image& image, const Image& reference)
+    {
+        if (!_SameSize(image, reference))
+        {
+            return std::nullopt;
+        }
+        return _CompareRegion(image, reference, 0, 0, image.width, image.height);
+    }
+
+    std::optional<std::vector<ImageError>> CompareTiles(const Image& image, const Image& reference, uint16_t tileSize)
+    {
+        if (!_SameSize(image, reference) || tileSize == 0)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<ImageError> tiles;
+        for (size_t y = 0; y < image.height; y += tileSize)
+        {
+            for (size_t x = 0; x < image.width; x += tileSize)
+            {
+                tiles.push_back(_CompareRegion(image, reference, x, y,
+                    std::min<size_t>(x + tileSize, image.width), std::min<size_t>(y + tileSize, image.height)));
+            }
+        }
+        return tiles;
+    }
+
+    double Efficiency(const ImageError& error, double seconds)
+    {
+        const double cost = error.relativeMSE * seconds;
+        return cost > 0.0 ? 1.0 / cost : std::numeric_limits<double>::infinity();
+    }
+
+    std::string JsonNumber(double value)
+    {
+        if (!std::isfinite(value))
+        {
+            return "null";
+        }
+        std::ostringstream out;
+        out << value;
+        return out.str();
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef RTX_WEEKEND_IMAGEMETRICS_H
+#define RTX_WEEKEND_IMAGEMETRICS_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+
+namespace hvk
+{
+    // How far an image is from a reference, over every channel in the [0, 1]
+    // units of Image
+    struct ImageError
+    {
+        double rmse;
+        // squared error relative to the squared reference, so that noise in
+        // dark regions counts as much as in bright ones
+        double relativeMSE;
+        // peak signal to noise ratio in dB, infinite for identical images
+        double psnr;
+    };
+
+    // Added to the reference in the denominator of relative MSE, so black
+    // reference pixels don't divide by zero
+    const double kRelativeMSEEpsilon = 0.01;
+
+    // Error of the whole image. Returns nullopt if their sizes differ.
+    std::optional<ImageError> CompareImages(const Image& image, const Image& reference);
+
+    // Error of each tileSize square of the image, rows of tiles top down, the
+    // last row and column cut short by the edges. Returns nullopt if their
+    // sizes differ.
+    std::optional<std::vector<ImageError>> CompareTiles(const Image& image, const Image& reference, uint16_t tileSize);
+
+    // Time to quality, higher is better: 1 / (relative MSE * seconds) stays
+    // about the same however many samples an unbiased renderer takes, so it
+    // compares renderers rather than sample counts
+    double Efficiency(const ImageError& error, double seconds);
+
+    // the value as JSON, which has no infinity, so the infinite PSNR and
+    // efficiency of identical images are written as null
+    std::string JsonNumber(double value);
+}
+
+#endif //RTX_WEEKEND_IMAGEMETRICS_H
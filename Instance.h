@@ -0,0 +1,20 @@
+#ifndef RTX_WEEKEND_INSTANCE_H
+#define RTX_WEEKEND_INSTANCE_H
+
+#include <memory>
+
+#include "Geometry.h"
+#include "Transform.h"
+
+namespace hvk
+{
+    // Places a shared Geometry (and its bottom level BVH) in the world.
+    // Moving an instance only invalidates the top level of the Scene.
+    struct Instance
+    {
+        std::shared_ptr<const Geometry> geometry;
+        Transform transform;
+    };
+}
+
+#endif //RTX_WEEKEND_INSTANCE_H
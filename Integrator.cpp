@@ -0,0 +1,144 @@
+#include "Integrator.h"
+#include "RayStats.h"
+#include "PathStats.h"
+#include "RayPacket.h"
+#include "math.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace hvk
+{
+    Color SkyColor(const Ray& r)
+    {
+        Vector unitDirection = r.getDirection();
+        auto t = (unitDirection.Y() + 1.f) * 0.5f;
+        return (kSkyColor1 * (1.0 - t)) + (kSkyColor2 * t);
+    }
+
+    bool _ScatterMetalOrBlue(const Ray& r, const Material& material, const HitRecord& hitRecord, Color& attenuation, Ray& scattered)
+    {
+        if (!ScatterMetal(r, material, hitRecord, attenuation, scattered))
+        {
+            attenuation = Color(0.f, 0.f, 1.f);
+            return false;
+        }
+        return true;
+    }
+
+    bool _ScatterDielectricFromAir(const Ray& r, const Material& material, const HitRecord& hitRecord, Color& attenuation, Ray& scattered)
+    {
+        return ScatterDielectric(r, material, kIORAir, hitRecord, attenuation, scattered);
+    }
+
+    using ScatterFunction = bool (*)(const Ray&, const Material&, const HitRecord&, Color&, Ray&);
+
+    // indexed by MaterialType, a new material type only needs its entry here
+    constexpr std::array<ScatterFunction, kNumMaterialTypes> kScatterFunctions = {
+        ScatterDiffuse,
+        _ScatterMetalOrBlue,
+        _ScatterDielectricFromAir
+    };
+    static_assert(kScatterFunctions.size() == static_cast<size_t>(MaterialType::Count));
+    // a missing entry would be left null rather than fail to compile
+    static_assert(std::none_of(kScatterFunctions.begin(), kScatterFunctions.end(), [](ScatterFunction scatter)
+    {
+        return scatter == nullptr;
+    }), "every MaterialType needs a scatter function");
+
+    bool Scatter(const Ray& r, const Material& material, const HitRecord& hitRecord, Color& attenuation, Ray& scattered)
+    {
+        return kScatterFunctions[static_cast<size_t>(material.getType())](r, material, hitRecord, attenuation, scattered);
+    }
+
+    // rayColor and shadeHit, passing down the type of the last surface the
+    // path scattered off so that the path's end can be counted against it
+    Color _ShadeHit(const Ray& r, const std::optional<SceneHit>& sceneHit, const Scene& scene, int depth, size_t lastMaterial);
+
+    Color _RayColor(const Ray& r, const Scene& scene, int depth, size_t lastMaterial)
+    {
+        if (depth <=0)
+        {
+            RTX_WEEKEND_COUNT_PATH(PathEnd::DepthLimit, lastMaterial, kMaxRayDepth - depth);
+            return Color(0.f, 0.f, 0.f);
+        }
+
+        // camera rays are counted by the kernels that trace them
+        RTX_WEEKEND_COUNT(bounceRays, 1);
+
+        // bounded primitives and instances live in the scene's acceleration
+        // structure, planes are tested once per ray after it
+        return _ShadeHit(r, scene.Intersect(r), scene, depth, lastMaterial);
+    }
+
+    Color _ShadeHit(const Ray& r, const std::optional<SceneHit>& sceneHit, const Scene& scene, int depth, size_t lastMaterial)
+    {
+        if (!sceneHit.has_value())
+        {
+            RTX_WEEKEND_COUNT_PATH(PathEnd::Sky, lastMaterial, kMaxRayDepth - depth);
+            return SkyColor(r);
+        }
+
+        const auto& earliestHitRecord = sceneHit->record;
+        const auto& earliestMaterial = *sceneHit->material;
+        const auto materialType = static_cast<size_t>(earliestMaterial.getType());
+
+        Ray scattered = Ray(Vector(), Vector());
+        Color attenuation(0.f, 0.f, 0.f);
+        if (Scatter(r, earliestMaterial, earliestHitRecord, attenuation, scattered))
+        {
+//            // add biasing
+//            scattered = Ray(scattered.getOrigin() + (0.01) * earliestHitRecord.normal.Normalized(), scattered.getDirection());
+            return attenuation * _RayColor(scattered, scene, depth-1, materialType);
+        }
+
+        RTX_WEEKEND_COUNT_PATH(
+            earliestMaterial.getType() == MaterialType::Metal ? PathEnd::FailedReflection : PathEnd::Absorbed,
+            materialType,
+            kMaxRayDepth - depth);
+        return attenuation;
+    }
+
+    Color rayColor(const Ray& r, const Scene& scene, int depth)
+    {
+        return _RayColor(r, scene, depth, kNoMaterial);
+    }
+
+    Color shadeHit(const Ray& r, const std::optional<SceneHit>& sceneHit, const Scene& scene, int depth)
+    {
+        return _ShadeHit(r, sceneHit, scene, depth, kNoMaterial);
+    }
+
+    Color SamplePixel(
+            const Scene& scene,
+            const Camera& camera,
+            int i,
+            int j,
+            uint16_t width,
+            uint16_t height,
+            size_t numSamples)
+    {
+        Color pixelColor(0.f, 0.f, 0.f);
+        for (size_t s = 0; s < numSamples; s += kPrimaryPacketSize)
+        {
+            RayPacket<kPrimaryPacketSize> packet;
+            const size_t numLanes = std::min<size_t>(kPrimaryPacketSize, numSamples - s);
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                auto u = static_cast<Real>(j + math::getRandom<Real, Real(0), Real(1)>()) / (width - 1);
+                auto v = static_cast<Real>(i + math::getRandom<Real, Real(0), Real(1)>()) / (height - 1);
+                packet.Set(lane, camera.GetRay(u, v));
+            }
+
+            std::array<std::optional<SceneHit>, kPrimaryPacketSize> primaryHits;
+            scene.IntersectPacket(packet, primaryHits);
+            RTX_WEEKEND_COUNT(cameraRays, numLanes);
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                pixelColor += shadeHit(packet.GetRay(lane), primaryHits[lane], scene, kMaxRayDepth);
+            }
+        }
+        return pixelColor;
+    }
+}
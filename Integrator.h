@@ -0,0 +1,53 @@
+#ifndef RTX_WEEKEND_INTEGRATOR_H
+#define RTX_WEEKEND_INTEGRATOR_H
+
+#include <cstdint>
+#include <optional>
+
+#include "Ray.h"
+#include "Vector.h"
+#include "Material.h"
+#include "HitRecord.h"
+#include "Scene.h"
+#include "Camera.h"
+
+namespace hvk
+{
+    const uint16_t kMaxRayDepth = 50;
+
+    // primary rays are traced in packets of this many samples of the same pixel
+    const size_t kPrimaryPacketSize = 8;
+
+    const Real kIORAir = 1;
+
+    // rays that miss everything blend from the first to the second going up
+    const Vector kSkyColor1 = Vector(1.f, 1.f, 1.f);
+    const Vector kSkyColor2 = Vector(0.5f, 0.7f, 1.f);
+
+    Color SkyColor(const Ray& r);
+
+    // Scatters r off the material at the hit. Returns false when the path ends
+    // there, in which case attenuation holds the color the path ends with.
+    bool Scatter(const Ray& r, const Material& material, const HitRecord& hitRecord, Color& attenuation, Ray& scattered);
+
+    // Traces a path. First hit attributes come from a GBuffer instead.
+    Color rayColor(const Ray& r, const Scene& scene, int depth);
+
+    // Shades a ray whose closest hit has already been found, continuing the path
+    // through rayColor. Lets packet traced primary rays join the scalar path.
+    Color shadeHit(const Ray& r, const std::optional<SceneHit>& sceneHit, const Scene& scene, int depth);
+
+    // Sums numSamples paths through pixel (i, j) of a width x height image,
+    // i counting scanlines from the bottom. The samples' primary rays share
+    // the camera origin and are nearly parallel, so they are traced in packets.
+    Color SamplePixel(
+            const Scene& scene,
+            const Camera& camera,
+            int i,
+            int j,
+            uint16_t width,
+            uint16_t height,
+            size_t numSamples);
+}
+
+#endif //RTX_WEEKEND_INTEGRATOR_H
@@ -0,0 +1,262 @@
+#include "BVH.h"
+#include "Morton.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace hvk
+{
+    template <typename MortonCode>
+    MortonCode _MortonEncode(float x, float y, float z);
+
+    template <>
+    uint32_t _MortonEncode<uint32_t>(float x, float y, float z)
+    {
+        return morton::Encode30(x, y, z);
+    }
+
+    template <>
+    uint64_t _MortonEncode<uint64_t>(float x, float y, float z)
+    {
+        return morton::Encode63(x, y, z);
+    }
+
+    template <typename Key>
+    void _RadixSort(std::vector<Key>& keys, std::vector<uint32_t>& values, size_t keyBits, ThreadPool* pool)
+    {
+        // LSD radix sort over 8 bit digits. Each chunk builds its own digit
+        // histogram, and since chunks scatter to disjoint, ordered ranges of
+        // the output every pass stays stable.
+        constexpr size_t kRadix = 256;
+        const size_t count = keys.size();
+        const size_t numChunks = pool != nullptr ? pool->getNumThreads() : 1;
+        const size_t chunkSize = std::max<size_t>((count + numChunks - 1) / numChunks, 1);
+
+        std::vector<Key> keysScratch(count);
+        std::vector<uint32_t> valuesScratch(count);
+        std::vector<std::array<size_t, kRadix>> offsets(numChunks);
+
+        const auto forEachChunk = [&](auto&& f) {
+            if (pool != nullptr)
+            {
+                pool->ParallelFor(count, chunkSize, f);
+            }
+            else
+            {
+                f(0, count);
+            }
+        };
+
+        for (size_t shift = 0; shift < keyBits; shift += 8)
+        {
+            for (auto& histogram : offsets)
+            {
+                histogram.fill(0);
+            }
+            forEachChunk([&](size_t begin, size_t end) {
+                auto& histogram = offsets[begin / chunkSize];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    ++histogram[(keys[i] >> shift) & (kRadix - 1)];
+                }
+            });
+
+            size_t running = 0;
+            for (size_t digit = 0; digit < kRadix; ++digit)
+            {
+                for (auto& histogram : offsets)
+                {
+                    const size_t digitCount = histogram[digit];
+                    histogram[digit] = running;
+                    running += digitCount;
+                }
+            }
+
+            forEachChunk([&](size_t begin, size_t end) {
+                auto& chunkOffsets = offsets[begin / chunkSize];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const size_t destination = chunkOffsets[(keys[i] >> shift) & (kRadix - 1)]++;
+                    keysScratch[destination] = keys[i];
+                    valuesScratch[destination] = values[i];
+                }
+            });
+
+            keys.swap(keysScratch);
+            values.swap(valuesScratch);
+        }
+    }
+
+    template <typename MortonCode>
+    uint32_t _FindMortonSplit(const std::vector<MortonCode>& codes, uint32_t first, uint32_t last)
+    {
+        // Returns the last index of the left half of [first, last], which is
+        // where the highest bit that differs across the range flips. Codes are
+        // sorted, so this is found with a binary search on the common prefix.
+        const auto firstCode = codes[first];
+        const auto lastCode = codes[last];
+        if (firstCode == lastCode)
+        {
+            return (first + last) / 2;
+        }
+
+        const int commonPrefix = std::countl_zero(static_cast<MortonCode>(firstCode ^ lastCode));
+        uint32_t split = first;
+        uint32_t step = last - first;
+        do
+        {
+            step = (step + 1) >> 1;
+            const uint32_t newSplit = split + step;
+            if (newSplit < last)
+            {
+                const int splitPrefix = std::countl_zero(static_cast<MortonCode>(firstCode ^ codes[newSplit]));
+                if (splitPrefix > commonPrefix)
+                {
+                    split = newSplit;
+                }
+            }
+        } while (step > 1);
+
+        return split;
+    }
+
+    void BVH::BuildLBVH(BuildState& state, ThreadPool* pool)
+    {
+        const auto numPrimitives = static_cast<uint32_t>(state.primitiveBounds.size());
+        const size_t numChunks = pool != nullptr ? pool->getNumThreads() : 1;
+        const size_t chunkSize = (numPrimitives + numChunks - 1) / numChunks;
+
+        std::vector<AABB> partialCentroidBounds(numChunks);
+        const auto computeCentroids = [&](size_t begin, size_t end) {
+            auto& bounds = partialCentroidBounds[begin / chunkSize];
+            for (size_t i = begin; i < end; ++i)
+            {
+                state.centroids[i] = state.primitiveBounds[i].Centroid();
+                bounds.Grow(state.centroids[i]);
+            }
+        };
+        if (pool != nullptr)
+        {
+            pool->ParallelFor(numPrimitives, chunkSize, computeCentroids);
+        }
+        else
+        {
+            computeCentroids(0, numPrimitives);
+        }
+
+        AABB centroidBounds;
+        for (const auto& bounds : partialCentroidBounds)
+        {
+            centroidBounds.Grow(bounds);
+        }
+
+        if (numPrimitives > kMaxPrimitivesFor30BitMorton)
+        {
+            BuildLBVHWithCodes<uint64_t>(state, centroidBounds, pool);
+        }
+        else
+        {
+            BuildLBVHWithCodes<uint32_t>(state, centroidBounds, pool);
+        }
+    }
+
+    template <typename MortonCode>
+    void BVH::BuildLBVHWithCodes(BuildState& state, const AABB& centroidBounds, ThreadPool* pool)
+    {
+        constexpr size_t kCodeBits = sizeof(MortonCode) == 4 ? 30 : 63;
+        const auto numPrimitives = static_cast<uint32_t>(state.primitiveBounds.size());
+
+        // quantize centroids relative to their bounds, flat axes map to 0
+        const auto minimum = centroidBounds.getMin();
+        const auto extent = centroidBounds.Extent();
+        const Vector scale(
+            extent.X() > 0.f ? 1.f / extent.X() : 0.f,
+            extent.Y() > 0.f ? 1.f / extent.Y() : 0.f,
+            extent.Z() > 0.f ? 1.f / extent.Z() : 0.f);
+
+        std::vector<MortonCode> codes(numPrimitives);
+        const auto computeCodes = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto normalized = (state.centroids[i] - minimum) * scale;
+                codes[i] = _MortonEncode<MortonCode>(normalized.X(), normalized.Y(), normalized.Z());
+            }
+        };
+        if (pool != nullptr)
+        {
+            pool->ParallelFor(numPrimitives, (numPrimitives + pool->getNumThreads() - 1) / pool->getNumThreads(), computeCodes);
+        }
+        else
+        {
+            computeCodes(0, numPrimitives);
+        }
+
+        _RadixSort(codes, mPrimitiveIndices, kCodeBits, pool);
+
+        mNodes[0] = BVHNode{ AABB(), 0, numPrimitives };
+        EmitLBVHSubtree(state, codes, 0, pool);
+        if (pool != nullptr)
+        {
+            pool->Wait();
+        }
+
+        mNodes.resize(state.nodesUsed.load());
+        RefitAllNodes(state.primitiveBounds);
+    }
+
+    template <typename MortonCode>
+    void BVH::EmitLBVHSubtree(BuildState& state, const std::vector<MortonCode>& codes, uint32_t nodeIndex, ThreadPool* pool)
+    {
+        const uint32_t first = mNodes[nodeIndex].leftFirst;
+        const uint32_t count = mNodes[nodeIndex].count;
+        if (count <= kMaxLBVHLeafSize)
+        {
+            return;
+        }
+
+        const uint32_t split = _FindMortonSplit(codes, first, first + count - 1);
+        const uint32_t leftCount = split - first + 1;
+        const auto leftIndex = state.nodesUsed.fetch_add(2);
+        mNodes[leftIndex] = BVHNode{ AABB(), first, leftCount };
+        mNodes[leftIndex + 1] = BVHNode{ AABB(), split + 1, count - leftCount };
+        mNodes[nodeIndex].leftFirst = leftIndex;
+        mNodes[nodeIndex].count = 0;
+
+        for (uint32_t child = leftIndex; child <= leftIndex + 1; ++child)
+        {
+            if (pool != nullptr && mNodes[child].count >= kParallelSubtreeThreshold)
+            {
+                pool->QueueWork([this, &state, &codes, child, pool]() {
+                    EmitLBVHSubtree(state, codes, child, pool);
+                });
+            }
+            else
+            {
+                EmitLBVHSubtree(state, codes, child, pool);
+            }
+        }
+    }
+
+    void BVH::RefitAllNodes(const std::vector<AABB>& primitiveBounds)
+    {
+        // children are always allocated after their parent, so walking the
+        // nodes backwards visits every child before the node that owns it
+        for (size_t i = mNodes.size(); i-- > 0;)
+        {
+            auto& node = mNodes[i];
+            node.bounds = AABB();
+            if (node.IsLeaf())
+            {
+                for (uint32_t p = 0; p < node.count; ++p)
+                {
+                    node.bounds.Grow(primitiveBounds[mPrimitiveIndices[node.leftFirst + p]]);
+                }
+            }
+            else
+            {
+                node.bounds = AABB::Union(mNodes[node.leftFirst].bounds, mNodes[node.leftFirst + 1].bounds);
+            }
+        }
+    }
+}
@@ -0,0 +1,182 @@
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hvk
+{
+    MappedFile::MappedFile()
+        : mData(nullptr)
+        , mSize(0)
+#if defined(_WIN32)
+        , mFile(INVALID_HANDLE_VALUE)
+        , mMapping(nullptr)
+#else
+        , mFile(-1)
+#endif
+    {
+
+    }
+
+    MappedFile::MappedFile(MappedFile&& rhs) noexcept
+        : MappedFile()
+    {
+        *this = std::move(rhs);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Close();
+            mData = std::exchange(rhs.mData, nullptr);
+            mSize = std::exchange(rhs.mSize, 0);
+#if defined(_WIN32)
+            mFile = std::exchange(rhs.mFile, INVALID_HANDLE_VALUE);
+            mMapping = std::exchange(rhs.mMapping, nullptr);
+#else
+            mFile = std::exchange(rhs.mFile, -1);
+#endif
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+#if defined(_WIN32)
+    std::optional<MappedFile> MappedFile::Open(const std::string& path, size_t size)
+    {
+        MappedFile mapped;
+        mapped.mFile = CreateFileA(
+            path.c_str(),
+            GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (mapped.mFile == INVALID_HANDLE_VALUE)
+        {
+            return std::nullopt;
+        }
+
+        LARGE_INTEGER existingSize = {};
+        if (!GetFileSizeEx(mapped.mFile, &existingSize) ||
+            (existingSize.QuadPart != 0 && static_cast<size_t>(existingSize.QuadPart) != size))
+        {
+            return std::nullopt;
+        }
+
+        // the mapping grows an empty file to its size
+        const auto size64 = static_cast<uint64_t>(size);
+        mapped.mMapping = CreateFileMappingA(
+            mapped.mFile,
+            nullptr,
+            PAGE_READWRITE,
+            static_cast<DWORD>(size64 >> 32),
+            static_cast<DWORD>(size64 & 0xffffffff),
+            nullptr);
+        if (mapped.mMapping == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        mapped.mData = static_cast<std::byte*>(MapViewOfFile(mapped.mMapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+        if (mapped.mData == nullptr)
+        {
+            return std::nullopt;
+        }
+        mapped.mSize = size;
+        return std::optional<MappedFile>(std::move(mapped));
+    }
+
+    bool MappedFile::Flush()
+    {
+        return FlushViewOfFile(mData, mSize) && FlushFileBuffers(mFile);
+    }
+
+    void MappedFile::Close()
+    {
+        if (mData != nullptr)
+        {
+            UnmapViewOfFile(mData);
+            mData = nullptr;
+        }
+        if (mMapping != nullptr)
+        {
+            CloseHandle(mMapping);
+            mMapping = nullptr;
+        }
+        if (mFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(mFile);
+            mFile = INVALID_HANDLE_VALUE;
+        }
+        mSize = 0;
+    }
+#else
+    std::optional<MappedFile> MappedFile::Open(const std::string& path, size_t size)
+    {
+        MappedFile mapped;
+        mapped.mFile = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (mapped.mFile < 0)
+        {
+            return std::nullopt;
+        }
+
+        struct stat status = {};
+        if (fstat(mapped.mFile, &status) != 0 ||
+            (status.st_size != 0 && static_cast<size_t>(status.st_size) != size))
+        {
+            return std::nullopt;
+        }
+        if (status.st_size == 0 && ftruncate(mapped.mFile, static_cast<off_t>(size)) != 0)
+        {
+            return std::nullopt;
+        }
+
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped.mFile, 0);
+        if (data == MAP_FAILED)
+        {
+            return std::nullopt;
+        }
+        mapped.mData = static_cast<std::byte*>(data);
+        mapped.mSize = size;
+        return std::optional<MappedFile>(std::move(mapped));
+    }
+
+    bool MappedFile::Flush()
+    {
+        return msync(mData, mSize, MS_SYNC) == 0;
+    }
+
+    void MappedFile::Close()
+    {
+        if (mData != nullptr)
+        {
+            munmap(mData, mSize);
+            mData = nullptr;
+        }
+        if (mFile >= 0)
+        {
+            close(mFile);
+            mFile = -1;
+        }
+        mSize = 0;
+    }
+#endif
+}
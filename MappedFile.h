@@ -0,0 +1,47 @@
+#ifndef RTX_WEEKEND_MAPPEDFILE_H
+#define RTX_WEEKEND_MAPPEDFILE_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace hvk
+{
+    // A file mapped read/write into memory, shared with the file so that
+    // writes land in it without any explicit I/O. Move only.
+    class MappedFile
+    {
+    public:
+        // Maps the file at path, creating it zero filled if it does not exist
+        // or is empty. Returns nullopt if it cannot be mapped or already holds
+        // a different number of bytes than size.
+        static std::optional<MappedFile> Open(const std::string& path, size_t size);
+
+        MappedFile(MappedFile&& rhs) noexcept;
+        MappedFile& operator=(MappedFile&& rhs) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        std::byte* getData() const { return mData; }
+        size_t getSize() const { return mSize; }
+
+        // blocks until everything written so far is on disk
+        bool Flush();
+
+    private:
+        MappedFile();
+        void Close();
+
+        std::byte* mData;
+        size_t mSize;
+#if defined(_WIN32)
+        void* mFile;
+        void* mMapping;
+#else
+        int mFile;
+#endif
+    };
+}
+
+#endif //RTX_WEEKEND_MAPPEDFILE_H
@@ -2,10 +2,10 @@
 
 namespace hvk
 {
-    Material::Material(MaterialType type, const Color &albedo, double ior)
-        : mType(type)
-        , mAlbedo(albedo)
+    Material::Material(MaterialType type, const Color &albedo, Real ior)
+        : mAlbedo(albedo)
         , mIOR(ior)
+        , mType(type)
     {}
 
     MaterialType Material::getType() const
@@ -15,14 +15,20 @@ namespace hvk
 
     Color Material::getAlbedo() const
     {
-        return mAlbedo;
+        return mAlbedo.Load();
     }
 
-    double Material::getIOR() const
+    Real Material::getIOR() const
     {
         return mIOR;
     }
 
+    bool Material::operator== (const Material& rhs) const
+    {
+        return mType == rhs.mType && mIOR == rhs.mIOR &&
+               mAlbedo.x == rhs.mAlbedo.x && mAlbedo.y == rhs.mAlbedo.y && mAlbedo.z == rhs.mAlbedo.z;
+    }
+
     bool ScatterDiffuse(const Ray &r, const Material &material, const HitRecord &hitRecord, Color &attenuation,
                         Ray &scattered)
     {
@@ -50,7 +56,7 @@ namespace hvk
     bool ScatterDielectric(
             const Ray &r,
             const Material &enterMaterial,
-            double leaveIOR,
+            Real leaveIOR,
             const HitRecord &hitRecord,
             Color &attenuation,
             Ray &scattered)
@@ -1,33 +1,46 @@
 #ifndef RTX_WEEKEND_MATERIAL_H
 #define RTX_WEEKEND_MATERIAL_H
 
+#include <cstddef>
+#include <cstdint>
+
 #include "Ray.h"
 #include "Vector.h"
 #include "HitRecord.h"
+#include "Float3.h"
+#include "Real.h"
 
 namespace hvk
 {
     using Color = Vector;
 
-    enum class MaterialType
+    enum class MaterialType : uint8_t
     {
         Diffuse,
         Metal,
-        Dielectric
+        Dielectric,
+        // not a type, the number of them
+        Count
     };
 
+    // number of MaterialTypes, the size of tables indexed by them
+    constexpr size_t kNumMaterialTypes = static_cast<size_t>(MaterialType::Count);
+
 
     class Material
     {
     public:
-        Material(MaterialType type, const Color& albedo, double ior);
+        Material(MaterialType type, const Color& albedo, Real ior);
         MaterialType getType() const;
         Color getAlbedo() const;
-        double getIOR() const;
+        Real getIOR() const;
+
+        bool operator== (const Material& rhs) const;
+
     private:
+        Float3 mAlbedo;
+        Real mIOR;
         MaterialType mType;
-        Color mAlbedo;
-        double mIOR;
     };
 
 
@@ -38,7 +51,7 @@ namespace hvk
     bool ScatterDielectric(
             const Ray &r,
             const Material &enterMaterial,
-            double leaveIOR,
+            Real leaveIOR,
             const HitRecord &hitRecord,
             Color &attenuation,
             Ray &scattered);
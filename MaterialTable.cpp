@@ -0,0 +1,71 @@
+#include "MaterialTable.h"
+
+#include <functional>
+
+namespace hvk
+{
+    MaterialTable::MaterialTable()
+        : mMaterials()
+        , mIds()
+        , mUseCounts()
+        , mFreeIds()
+    {
+    }
+
+    MaterialId MaterialTable::Add(const Material& material)
+    {
+        const MaterialId freeId = mFreeIds.empty() ? static_cast<MaterialId>(mMaterials.size()) : mFreeIds.back();
+        const auto [it, added] = mIds.try_emplace(material, freeId);
+        if (!added)
+        {
+            ++mUseCounts[it->second];
+            return it->second;
+        }
+
+        if (freeId < mMaterials.size())
+        {
+            mFreeIds.pop_back();
+            mMaterials[freeId] = material;
+            mUseCounts[freeId] = 1;
+        }
+        else
+        {
+            mMaterials.push_back(material);
+            mUseCounts.push_back(1);
+        }
+        return freeId;
+    }
+
+    void MaterialTable::Release(MaterialId id)
+    {
+        if (--mUseCounts[id] == 0)
+        {
+            mIds.erase(mMaterials[id]);
+            mFreeIds.push_back(id);
+        }
+    }
+
+    size_t MaterialTable::getSize() const
+    {
+        return mMaterials.size();
+    }
+
+    void MaterialTable::Clear()
+    {
+        mMaterials.clear();
+        mIds.clear();
+        mUseCounts.clear();
+        mFreeIds.clear();
+    }
+
+    size_t MaterialTable::MaterialHash::operator() (const Material& material) const
+    {
+        const auto albedo = material.getAlbedo();
+        size_t hash = std::hash<int>()(static_cast<int>(material.getType()));
+        for (const auto value : { albedo.X(), albedo.Y(), albedo.Z(), static_cast<float>(material.getIOR()) })
+        {
+            hash = hash * 31 + std::hash<float>()(value);
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef RTX_WEEKEND_MATERIALTABLE_H
+#define RTX_WEEKEND_MATERIALTABLE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Material.h"
+
+namespace hvk
+{
+    using MaterialId = uint32_t;
+
+    // Flat array of unique materials. Primitives refer to their material by
+    // a 32 bit id rather than each carrying a copy, so identical materials
+    // are stored once no matter how many primitives share them. Each id
+    // counts its users, and a slot no one uses any more is reused by the
+    // next new material, so repainting primitives doesn't grow the table.
+    class MaterialTable
+    {
+    public:
+        MaterialTable();
+
+        // returns the id of an equal material if there is one, otherwise
+        // stores the material in a free slot or at the end and returns its
+        // new id. Either way the id gains a user.
+        MaterialId Add(const Material& material);
+        // drops a user of the id Add returned, freeing its slot with the last
+        void Release(MaterialId id);
+        const Material& Get(MaterialId id) const { return mMaterials[id]; }
+        // slots, free ones included
+        size_t getSize() const;
+        void Clear();
+
+    private:
+        struct MaterialHash
+        {
+            size_t operator() (const Material& material) const;
+        };
+
+        std::vector<Material> mMaterials;
+        std::unordered_map<Material, MaterialId, MaterialHash> mIds;
+        std::vector<uint32_t> mUseCounts;
+        std::vector<MaterialId> mFreeIds;
+    };
+}
+
+#endif //RTX_WEEKEND_MATERIALTABLE_H
@@ -0,0 +1,54 @@
+#ifndef RTX_WEEKEND_MORTON_H
+#define RTX_WEEKEND_MORTON_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace hvk
+{
+    namespace morton
+    {
+        inline uint32_t ExpandBits10(uint32_t v)
+        {
+            // spreads the low 10 bits of v out so there are two zero bits between each
+            v &= 0x3ff;
+            v = (v | (v << 16)) & 0x030000ff;
+            v = (v | (v << 8)) & 0x0300f00f;
+            v = (v | (v << 4)) & 0x030c30c3;
+            v = (v | (v << 2)) & 0x09249249;
+            return v;
+        }
+
+        inline uint64_t ExpandBits21(uint64_t v)
+        {
+            // spreads the low 21 bits of v out so there are two zero bits between each
+            v &= 0x1fffff;
+            v = (v | (v << 32)) & 0x001f00000000ffffull;
+            v = (v | (v << 16)) & 0x001f0000ff0000ffull;
+            v = (v | (v << 8)) & 0x100f00f00f00f00full;
+            v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+            v = (v | (v << 2)) & 0x1249249249249249ull;
+            return v;
+        }
+
+        // 30 bit code, 10 bits per axis, of a point in the unit cube
+        inline uint32_t Encode30(float x, float y, float z)
+        {
+            const auto quantize = [](float f) {
+                return static_cast<uint32_t>(std::clamp(f * 1024.f, 0.f, 1023.f));
+            };
+            return (ExpandBits10(quantize(x)) << 2) | (ExpandBits10(quantize(y)) << 1) | ExpandBits10(quantize(z));
+        }
+
+        // 63 bit code, 21 bits per axis, of a point in the unit cube
+        inline uint64_t Encode63(float x, float y, float z)
+        {
+            const auto quantize = [](float f) {
+                return static_cast<uint64_t>(std::clamp(f * 2097152.f, 0.f, 2097151.f));
+            };
+            return (ExpandBits21(quantize(x)) << 2) | (ExpandBits21(quantize(y)) << 1) | ExpandBits21(quantize(z));
+        }
+    }
+}
+
+#endif //RTX_WEEKEND_MORTON_H
@@ -0,0 +1,53 @@
+#ifndef RTX_WEEKEND_NODECACHESIMULATOR_H
+#define RTX_WEEKEND_NODECACHESIMULATOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace hvk
+{
+    // A direct mapped cache model that BVH traversal reports its node fetches
+    // to. It is far too simple to predict real miss rates, but it is enough to
+    // compare how well two ray orders reuse the nodes they pull in.
+    class NodeCacheSimulator
+    {
+    public:
+        static constexpr size_t kLineSize = 64;
+        static constexpr size_t kNumLines = 512;
+
+        NodeCacheSimulator() : mTags(), mAccesses(0), mMisses(0)
+        {
+            mTags.fill(UINTPTR_MAX);
+        }
+
+        void Touch(const void* address)
+        {
+            const auto line = reinterpret_cast<uintptr_t>(address) / kLineSize;
+            auto& tag = mTags[line % kNumLines];
+            ++mAccesses;
+            if (tag != line)
+            {
+                tag = line;
+                ++mMisses;
+            }
+        }
+
+        uint64_t getAccesses() const { return mAccesses; }
+        uint64_t getMisses() const { return mMisses; }
+
+        // the simulator traversals on this thread report to, or nullptr
+        static NodeCacheSimulator*& Current()
+        {
+            thread_local NodeCacheSimulator* current = nullptr;
+            return current;
+        }
+
+    private:
+        std::array<uintptr_t, kNumLines> mTags;
+        uint64_t mAccesses;
+        uint64_t mMisses;
+    };
+}
+
+#endif //RTX_WEEKEND_NODECACHESIMULATOR_H
@@ -0,0 +1,198 @@
+#include "Options.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace hvk
+{
+    void _PrintUsage(const char* program)
+    {
+        std::cerr << "usage: " << program << " [options] > image.ppm\n"
+                  << "  --scene NAME          demo, cover, boxes or glass, see Scenes.h\n"
+                  << "  --samples N           samples per pixel\n"
+                  << "  --progressive         render in passes, stopping early if the budget runs out\n"
+                  << "  --pass-samples N      samples per pixel added by each progressive pass\n"
+                  << "  --time-budget-ms N    stop starting new work N ms into the render, implies --progressive\n"
+                  << "  --progress-file PATH  write the image to PATH after every pass\n"
+                  << "  --stats-json PATH     write the ray counts and rates of the render to PATH\n"
+                  << "  --trace PATH          write a Chrome trace of the build, tiles, denoise and output to PATH\n"
+                  << "  --cost-heatmap        add the render time of each pixel to the output mosaic\n"
+                  << "  --denoise             filter the image, and every progress file, guided by the G-buffer\n"
+                  << "  --beauty-only         write only the image, not the mosaic of it and its G-buffer\n"
+                  << "  --checkpoint PATH     keep the accumulated samples in PATH, resuming from it if it exists,\n"
+                  << "                        implies --progressive\n"
+                  << "  --seed N              seed for the sampling\n"
+                  << "  --shard I/N           render only shard I of N into the checkpoint, for merge\n"
+                  << "  --shard-by MODE       split shards by tile rows or by samples, rows by default\n"
+                  << "  --serve PORT          hand tiles out to workers on PORT and write the image they render\n"
+                  << "  --worker HOST:PORT    render tiles for the coordinator at HOST:PORT\n"
+                  << "\n"
+                  << "usage: " << program << " merge CHECKPOINT... > image.ppm\n"
+                  << "  adds up the samples of the checkpoints of one image and resolves it\n";
+    }
+
+    std::optional<uint32_t> _ParseUnsigned(const char* text, uint32_t minValue, uint32_t maxValue)
+    {
+        char* end = nullptr;
+        const unsigned long long value = std::strtoull(text, &end, 10);
+        if (end == text || *end != '\0' || text[0] == '-' || value < minValue || value > maxValue)
+        {
+            return std::nullopt;
+        }
+        return static_cast<uint32_t>(value);
+    }
+
+    std::optional<RenderOptions> ParseOptions(int argc, const char* const* argv, const RenderOptions& defaults)
+    {
+        RenderOptions options = defaults;
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* argument = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+            std::optional<uint32_t> number;
+            bool valid = true;
+
+            if (std::strcmp(argument, "--progressive") == 0)
+            {
+                options.progressive = true;
+                continue;
+            }
+            if (std::strcmp(argument, "--cost-heatmap") == 0)
+            {
+                options.costHeatmap = true;
+                continue;
+            }
+            if (std::strcmp(argument, "--denoise") == 0)
+            {
+                options.denoise = true;
+                continue;
+            }
+            if (std::strcmp(argument, "--beauty-only") == 0)
+            {
+                options.beautyOnly = true;
+                continue;
+            }
+
+            if (value == nullptr)
+            {
+                valid = false;
+            }
+            else if (std::strcmp(argument, "--samples") == 0)
+            {
+                number = _ParseUnsigned(value, 1, UINT16_MAX);
+                options.numSamples = static_cast<uint16_t>(number.value_or(0));
+                valid = number.has_value();
+            }
+            else if (std::strcmp(argument, "--pass-samples") == 0)
+            {
+                number = _ParseUnsigned(value, 1, UINT16_MAX);
+                options.passSamples = static_cast<uint16_t>(number.value_or(0));
+                valid = number.has_value();
+            }
+            else if (std::strcmp(argument, "--time-budget-ms") == 0)
+            {
+                options.timeBudgetMs = _ParseUnsigned(value, 0, UINT32_MAX);
+                options.progressive = true;
+                valid = options.timeBudgetMs.has_value();
+            }
+            else if (std::strcmp(argument, "--progress-file") == 0)
+            {
+                options.progressPath = std::string(value);
+            }
+            else if (std::strcmp(argument, "--scene") == 0)
+            {
+                options.sceneName = std::string(value);
+            }
+            else if (std::strcmp(argument, "--stats-json") == 0)
+            {
+                options.statsPath = std::string(value);
+            }
+            else if (std::strcmp(argument, "--trace") == 0)
+            {
+                options.tracePath = std::string(value);
+            }
+            else if (std::strcmp(argument, "--checkpoint") == 0)
+            {
+                options.checkpointPath = std::string(value);
+                options.progressive = true;
+            }
+            else if (std::strcmp(argument, "--seed") == 0)
+            {
+                number = _ParseUnsigned(value, 0, UINT32_MAX);
+                options.seed = number.value_or(0);
+                valid = number.has_value();
+            }
+            else if (std::strcmp(argument, "--shard") == 0)
+            {
+                // I/N
+                const char* slash = std::strchr(value, '/');
+                const auto count = slash != nullptr ? _ParseUnsigned(slash + 1, 1, UINT16_MAX) : std::nullopt;
+                const auto index = slash != nullptr ?
+                    _ParseUnsigned(std::string(value, slash).c_str(), 0, count.value_or(1) - 1) :
+                    std::nullopt;
+                options.shardIndex = static_cast<uint16_t>(index.value_or(0));
+                options.shardCount = static_cast<uint16_t>(count.value_or(1));
+                valid = index.has_value() && count.has_value();
+            }
+            else if (std::strcmp(argument, "--serve") == 0)
+            {
+                number = _ParseUnsigned(value, 1, UINT16_MAX);
+                options.servePort = number.has_value() ? std::make_optional(static_cast<uint16_t>(number.value())) : std::nullopt;
+                valid = number.has_value();
+            }
+            else if (std::strcmp(argument, "--worker") == 0)
+            {
+                // HOST:PORT
+                const char* colon = std::strrchr(value, ':');
+                number = colon != nullptr ? _ParseUnsigned(colon + 1, 1, UINT16_MAX) : std::nullopt;
+                options.workerHost = colon != nullptr ? std::make_optional(std::string(value, colon)) : std::nullopt;
+                options.workerPort = static_cast<uint16_t>(number.value_or(0));
+                valid = number.has_value() && colon != value;
+            }
+            else if (std::strcmp(argument, "--shard-by") == 0)
+            {
+                if (std::strcmp(value, "rows") == 0)
+                {
+                    options.shardMode = ShardMode::Rows;
+                }
+                else if (std::strcmp(value, "samples") == 0)
+                {
+                    options.shardMode = ShardMode::Samples;
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if (!valid)
+            {
+                std::cerr << "bad argument: " << argument << std::endl;
+                _PrintUsage(argv[0]);
+                return std::nullopt;
+            }
+            ++i;
+        }
+
+        // a shard's samples are only of use in its checkpoint
+        if (options.shardCount > 1 && !options.checkpointPath.has_value())
+        {
+            std::cerr << "--shard needs a --checkpoint to render into" << std::endl;
+            _PrintUsage(argv[0]);
+            return std::nullopt;
+        }
+        if (static_cast<int>(options.shardCount > 1) + static_cast<int>(options.servePort.has_value()) +
+            static_cast<int>(options.workerHost.has_value()) > 1)
+        {
+            std::cerr << "--shard, --serve and --worker do not go together" << std::endl;
+            _PrintUsage(argv[0]);
+            return std::nullopt;
+        }
+        return options;
+    }
+}
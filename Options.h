@@ -0,0 +1,67 @@
+#ifndef RTX_WEEKEND_OPTIONS_H
+#define RTX_WEEKEND_OPTIONS_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace hvk
+{
+    enum class ShardMode
+    {
+        // each shard renders every sample of a band of tile rows
+        Rows,
+        // each shard renders its share of every pixel's samples
+        Samples
+    };
+
+    // What main takes from its command line. Anything not given keeps the
+    // default it was parsed over.
+    struct RenderOptions
+    {
+        // one of scenes::kCanonical
+        std::string sceneName;
+        uint16_t numSamples;
+        // render in passes of passSamples over the whole image, publishing
+        // the image after each, until numSamples or the time budget is reached
+        bool progressive;
+        uint16_t passSamples;
+        std::optional<uint32_t> timeBudgetMs;
+        // where each pass's image is written, replacing the previous one
+        std::optional<std::string> progressPath;
+        // where the ray counters are written as JSON after the render, see RayStats.h
+        std::optional<std::string> statsPath;
+        // where the timeline of the run is written, see Trace.h
+        std::optional<std::string> tracePath;
+        // add the time spent on each pixel to the image's mosaic
+        bool costHeatmap;
+        // write only the image, without the G-buffer and heatmap mosaic,
+        // e.g. to compare against a reference with rtx_compare
+        bool beautyOnly;
+        // Filter the image, and each published pass, guided by the G-buffer.
+        // With it on, around 16 samples give previews of much the same look
+        // as 200 without, see Denoiser.
+        bool denoise;
+        // accumulation buffers mapped from this file, synced after each pass,
+        // so that a later run with the same path resumes or adds samples
+        std::optional<std::string> checkpointPath;
+        // seeds the sampling, see math::setRandomSeed
+        uint32_t seed;
+        // This process renders shard shardIndex of shardCount into its
+        // checkpoint, for the merge command to combine with the others.
+        uint16_t shardIndex;
+        uint16_t shardCount;
+        ShardMode shardMode;
+        // serve tiles of the image to workers on this port, see TileCoordinator
+        std::optional<uint16_t> servePort;
+        // render tiles for the coordinator at workerHost:workerPort
+        std::optional<std::string> workerHost;
+        uint16_t workerPort;
+    };
+
+    // Parses argv over defaults. Returns nullopt after printing the usage to
+    // std::cerr if an argument is unknown or malformed.
+    std::optional<RenderOptions> ParseOptions(int argc, const char* const* argv, const RenderOptions& defaults);
+}
+
+#endif //RTX_WEEKEND_OPTIONS_H
@@ -0,0 +1,31 @@
+#include "PathStats.h"
+
+#include <deque>
+#include <mutex>
+
+namespace hvk
+{
+    namespace stats
+    {
+        // a deque, so blocks stay put as threads register
+        std::mutex _pathRegistryMutex;
+        std::deque<PathCounters> _pathRegistry;
+
+        PathCounters& RegisterPaths()
+        {
+            std::unique_lock<std::mutex> lock(_pathRegistryMutex);
+            return _pathRegistry.emplace_back();
+        }
+
+        PathCounters CollectPaths()
+        {
+            std::unique_lock<std::mutex> lock(_pathRegistryMutex);
+            PathCounters total;
+            for (const auto& counters : _pathRegistry)
+            {
+                total += counters;
+            }
+            return total;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef RTX_WEEKEND_PATHSTATS_H
+#define RTX_WEEKEND_PATHSTATS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Material.h"
+#include "Integrator.h"
+
+namespace hvk
+{
+    enum class PathEnd : uint8_t
+    {
+        // missed everything and took the sky's color
+        Sky,
+        // still scattering after kMaxRayDepth bounces, ends black
+        DepthLimit,
+        // a metal reflection that went below the surface, see Scatter
+        FailedReflection,
+        // any other surface that did not scatter
+        Absorbed
+    };
+
+    constexpr size_t kNumPathEnds = 4;
+
+    // the material slot of paths that hit nothing at all
+    constexpr size_t kNoMaterial = kNumMaterialTypes;
+
+    // How the paths of a render ended, counted per thread like RayCounters
+    struct alignas(64) PathCounters
+    {
+        // indexed by PathEnd, then the type of the last surface the path hit
+        // or kNoMaterial, then how many times the path scattered
+        std::array<std::array<std::array<uint64_t, kMaxRayDepth + 1>, kNumMaterialTypes + 1>, kNumPathEnds> paths = {};
+
+        void Add(PathEnd end, size_t material, size_t bounces)
+        {
+            ++paths[static_cast<size_t>(end)][material][bounces];
+        }
+
+        PathCounters& operator+= (const PathCounters& rhs)
+        {
+            for (size_t end = 0; end < kNumPathEnds; ++end)
+            {
+                for (size_t material = 0; material <= kNumMaterialTypes; ++material)
+                {
+                    for (size_t bounces = 0; bounces <= kMaxRayDepth; ++bounces)
+                    {
+                        paths[end][material][bounces] += rhs.paths[end][material][bounces];
+                    }
+                }
+            }
+            return *this;
+        }
+    };
+
+    namespace stats
+    {
+        // a new block for the calling thread, see LocalPaths
+        PathCounters& RegisterPaths();
+
+        // this thread's path counters
+        inline PathCounters& LocalPaths()
+        {
+            thread_local PathCounters& counters = RegisterPaths();
+            return counters;
+        }
+
+        // the sum over every thread that has counted, only exact while none is counting
+        PathCounters CollectPaths();
+    }
+}
+
+// compiled with the ray counters, see RayStats.h
+#if defined(RTX_WEEKEND_RAY_STATS)
+#define RTX_WEEKEND_COUNT_PATH(end, material, bounces) (::hvk::stats::LocalPaths().Add((end), (material), (bounces)))
+#else
+#define RTX_WEEKEND_COUNT_PATH(end, material, bounces) ((void)(end), (void)(material), (void)(bounces))
+#endif
+
+#endif //RTX_WEEKEND_PATHSTATS_H
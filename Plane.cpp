@@ -16,11 +16,11 @@ namespace hvk
 
     Vector Plane::getOrigin() const
     {
-        return mOrigin;
+        return mOrigin.Load();
     }
 
     Vector Plane::getDirection() const
     {
-        return mDirection;
+        return mDirection.Load();
     }
 }
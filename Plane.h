@@ -2,6 +2,7 @@
 #define RTX_WEEKEND_PLANE_H
 
 #include "Vector.h"
+#include "Float3.h"
 
 namespace hvk
 {
@@ -14,8 +15,8 @@ namespace hvk
         Vector getDirection() const;
         Vector getOrigin() const;
     private:
-        Vector mOrigin;
-        Vector mDirection;
+        Float3 mOrigin;
+        Float3 mDirection;
     };
 }
 
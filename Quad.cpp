@@ -0,0 +1,54 @@
+#include "Quad.h"
+
+namespace hvk
+{
+    Quad::Quad(const Vector& corner, const Vector& u, const Vector& v)
+        : mCorner(corner)
+        , mU(u)
+        , mV(v)
+    {
+    }
+
+    Quad::Quad()
+        : mCorner()
+        , mU()
+        , mV()
+    {
+    }
+
+    Vector Quad::getCorner() const
+    {
+        return mCorner.Load();
+    }
+
+    Vector Quad::getU() const
+    {
+        return mU.Load();
+    }
+
+    Vector Quad::getV() const
+    {
+        return mV.Load();
+    }
+
+    Vector Quad::getNormal() const
+    {
+        return Vector::Cross(mU.Load(), mV.Load()).Normalized();
+    }
+
+    AABB Quad::getBounds() const
+    {
+        AABB bounds;
+        const auto corner = mCorner.Load();
+        const auto u = mU.Load();
+        const auto v = mV.Load();
+        bounds.Grow(corner);
+        bounds.Grow(corner + u);
+        bounds.Grow(corner + v);
+        bounds.Grow(corner + u + v);
+
+        // pad so an axis aligned quad doesn't produce flat bounds
+        const Vector padding(1e-4f, 1e-4f, 1e-4f);
+        return AABB(bounds.getMin() - padding, bounds.getMax() + padding);
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef RTX_WEEKEND_QUAD_H
+#define RTX_WEEKEND_QUAD_H
+
+#include "Vector.h"
+#include "AABB.h"
+#include "Float3.h"
+
+namespace hvk
+{
+    // Bounded parallelogram spanned by two edges from a corner. Unlike Plane
+    // it has finite bounds, so it can be placed in a BVH.
+    class Quad
+    {
+    public:
+        Quad(const Vector& corner, const Vector& u, const Vector& v);
+        Quad();
+
+        Vector getCorner() const;
+        Vector getU() const;
+        Vector getV() const;
+        Vector getNormal() const;
+        AABB getBounds() const;
+
+    private:
+        Float3 mCorner;
+        Float3 mU;
+        Float3 mV;
+    };
+}
+
+#endif //RTX_WEEKEND_QUAD_H
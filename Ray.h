@@ -4,6 +4,7 @@
 #include <utility>
 
 #include "Vector.h"
+#include "Real.h"
 
 using namespace DirectX;
 
@@ -26,9 +27,9 @@ namespace hvk
 
         }
 
-        Vector PointAt(float t) const
+        Vector PointAt(Real t) const
         {
-            return mOrigin + (mDirection.Normalized() * t);
+            return mOrigin + (mDirection.Normalized() * static_cast<float>(t));
         }
 
         Vector getDirection() const { return mDirection.Normalized(); }
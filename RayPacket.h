@@ -0,0 +1,86 @@
+#ifndef RTX_WEEKEND_RAYPACKET_H
+#define RTX_WEEKEND_RAYPACKET_H
+
+#include <array>
+#include <cstdint>
+
+#include "Ray.h"
+#include "math.h"
+
+namespace hvk
+{
+    // A bundle of N rays stored as structure of arrays, so that per lane work
+    // like the slab test against a BVH node runs across all lanes at once.
+    template <size_t N>
+    struct RayPacket
+    {
+        static_assert(N == 4 || N == 8 || N == 16, "packets are 4, 8 or 16 rays wide");
+
+        using Mask = uint32_t;
+        static constexpr size_t kWidth = N;
+
+        alignas(64) std::array<float, N> originX = {};
+        alignas(64) std::array<float, N> originY = {};
+        alignas(64) std::array<float, N> originZ = {};
+        alignas(64) std::array<float, N> directionX = {};
+        alignas(64) std::array<float, N> directionY = {};
+        alignas(64) std::array<float, N> directionZ = {};
+        alignas(64) std::array<float, N> inverseDirectionX = {};
+        alignas(64) std::array<float, N> inverseDirectionY = {};
+        alignas(64) std::array<float, N> inverseDirectionZ = {};
+        // lanes holding a ray
+        Mask active = 0;
+
+        void Set(size_t lane, const Ray& ray)
+        {
+            const auto origin = ray.getOrigin();
+            const auto direction = ray.getDirection();
+            originX[lane] = origin.X();
+            originY[lane] = origin.Y();
+            originZ[lane] = origin.Z();
+            directionX[lane] = direction.X();
+            directionY[lane] = direction.Y();
+            directionZ[lane] = direction.Z();
+            inverseDirectionX[lane] = math::slabInverse(directionX[lane]);
+            inverseDirectionY[lane] = math::slabInverse(directionY[lane]);
+            inverseDirectionZ[lane] = math::slabInverse(directionZ[lane]);
+            active |= Mask(1) << lane;
+        }
+
+        Ray GetRay(size_t lane) const
+        {
+            return Ray(
+                Vector(originX[lane], originY[lane], originZ[lane]),
+                Vector(directionX[lane], directionY[lane], directionZ[lane]));
+        }
+
+        bool IsActive(size_t lane) const
+        {
+            return (active & (Mask(1) << lane)) != 0;
+        }
+
+        // Packets only pay off when their rays travel the same way through the
+        // hierarchy. Requiring every active ray's direction to agree in sign on
+        // each axis keeps the packet's interval bounds tight and meaningful.
+        bool IsCoherent() const
+        {
+            Mask positive[3] = { 0, 0, 0 };
+            for (size_t lane = 0; lane < N; ++lane)
+            {
+                positive[0] |= Mask(directionX[lane] >= 0.f) << lane;
+                positive[1] |= Mask(directionY[lane] >= 0.f) << lane;
+                positive[2] |= Mask(directionZ[lane] >= 0.f) << lane;
+            }
+            for (const auto axis : positive)
+            {
+                if ((axis & active) != 0 && (axis & active) != active)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+}
+
+#endif //RTX_WEEKEND_RAYPACKET_H
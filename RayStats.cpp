@@ -0,0 +1,41 @@
+#include "RayStats.h"
+
+#include <deque>
+#include <mutex>
+
+namespace hvk
+{
+    namespace stats
+    {
+        // a deque, so blocks stay put as threads register
+        std::mutex _registryMutex;
+        std::deque<RayCounters> _registry;
+
+        RayCounters& Register()
+        {
+            std::unique_lock<std::mutex> lock(_registryMutex);
+            return _registry.emplace_back();
+        }
+
+        RayCounters Collect()
+        {
+            std::unique_lock<std::mutex> lock(_registryMutex);
+            RayCounters total;
+            for (const auto& counters : _registry)
+            {
+                total += counters;
+            }
+            return total;
+        }
+
+        void Reset()
+        {
+            std::unique_lock<std::mutex> lock(_registryMutex);
+            for (auto& counters : _registry)
+            {
+                counters = RayCounters();
+            }
+        }
+    }
+}
+
@@ -0,0 +1,65 @@
+#ifndef RTX_WEEKEND_RAYSTATS_H
+#define RTX_WEEKEND_RAYSTATS_H
+
+#include <cstdint>
+
+namespace hvk
+{
+    // What the threads of a render did. Each thread counts into its own block,
+    // a cache line to itself so counting never contends, and the blocks are
+    // only added up once the threads are done.
+    struct alignas(64) RayCounters
+    {
+        // rays leaving the camera, one per sample
+        uint64_t cameraRays = 0;
+        // rays scattered off a surface
+        uint64_t bounceRays = 0;
+        // ray against primitive tests, see hittest.h
+        uint64_t primitiveTests = 0;
+        // BVH nodes whose bounds a ray was tested against, once per packet
+        // for packet traversal
+        uint64_t nodeVisits = 0;
+
+        RayCounters& operator+= (const RayCounters& rhs)
+        {
+            cameraRays += rhs.cameraRays;
+            bounceRays += rhs.bounceRays;
+            primitiveTests += rhs.primitiveTests;
+            nodeVisits += rhs.nodeVisits;
+            return *this;
+        }
+    };
+
+    namespace stats
+    {
+        // a new block for the calling thread, see Local
+        RayCounters& Register();
+
+        // this thread's counters
+        inline RayCounters& Local()
+        {
+            thread_local RayCounters& counters = Register();
+            return counters;
+        }
+
+        // the sum over every thread that has counted, only exact while none is counting
+        RayCounters Collect();
+        // zeroes every thread's counters, while none is counting
+        void Reset();
+
+        // counting is compiled out unless the build asks for it, see CMakeLists.txt
+#if defined(RTX_WEEKEND_RAY_STATS)
+        constexpr bool kEnabled = true;
+#else
+        constexpr bool kEnabled = false;
+#endif
+    }
+}
+
+#if defined(RTX_WEEKEND_RAY_STATS)
+#define RTX_WEEKEND_COUNT(counter, n) (::hvk::stats::Local().counter += (n))
+#else
+#define RTX_WEEKEND_COUNT(counter, n) ((void)0)
+#endif
+
+#endif //RTX_WEEKEND_RAYSTATS_H
@@ -0,0 +1,17 @@
+#ifndef RTX_WEEKEND_REAL_H
+#define RTX_WEEKEND_REAL_H
+
+namespace hvk
+{
+    // Scalar type for the math that doesn't run in Vector's float lanes:
+    // intersection roots, hit distances, indices of refraction, camera
+    // parameters and random samples. Float unless the build defines
+    // RTX_WEEKEND_DOUBLE_PRECISION, which gives a double precision reference.
+#if defined(RTX_WEEKEND_DOUBLE_PRECISION)
+    using Real = double;
+#else
+    using Real = float;
+#endif
+}
+
+#endif //RTX_WEEKEND_REAL_H
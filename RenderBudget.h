@@ -0,0 +1,40 @@
+#ifndef RTX_WEEKEND_RENDERBUDGET_H
+#define RTX_WEEKEND_RENDERBUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+namespace hvk
+{
+    // Decides when a progressive render has to stop: once an optional time
+    // budget, counted from construction, runs out or once cancelRequested is
+    // set, e.g. from a signal handler. Cheap enough to ask before every task.
+    class RenderBudget
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        RenderBudget(std::optional<Clock::duration> timeBudget, const std::atomic<bool>& cancelRequested)
+            : mDeadline()
+            , mCancelRequested(cancelRequested)
+        {
+            if (timeBudget.has_value())
+            {
+                mDeadline = Clock::now() + timeBudget.value();
+            }
+        }
+
+        bool IsExhausted() const
+        {
+            return mCancelRequested.load(std::memory_order_relaxed) ||
+                (mDeadline.has_value() && Clock::now() >= mDeadline.value());
+        }
+
+    private:
+        std::optional<Clock::time_point> mDeadline;
+        const std::atomic<bool>& mCancelRequested;
+    };
+}
+
+#endif //RTX_WEEKEND_RENDERBUDGET_H
@@ -0,0 +1,247 @@
+#include "SPMDIntegrator.h"
+
+#if defined(__AVX2__)
+
+#include <bit>
+#include <limits>
+#include <optional>
+
+#include "math.h"
+#include "RayStats.h"
+#include "PathStats.h"
+
+namespace hvk
+{
+    std::array<uint32_t, 8> _SeedLanes()
+    {
+        std::array<uint32_t, 8> seeds;
+        for (auto& seed : seeds)
+        {
+            // xorshift never leaves 0, so keep the low bit set
+            seed = static_cast<uint32_t>(math::getRandom<double, 0.0, 1.0>() * 4294967295.0) | 1u;
+        }
+        return seeds;
+    }
+
+    Vector8 _Load(const std::array<float, 8>& x, const std::array<float, 8>& y, const std::array<float, 8>& z)
+    {
+        return { Float8::Load(x), Float8::Load(y), Float8::Load(z) };
+    }
+
+    // math::slabInverse of every lane
+    Float8 _SlabInverse(const Float8& x)
+    {
+        const Float8 largest(std::numeric_limits<float>::max());
+        return Float8::Min(Float8::Max(Float8(1.f) / x, -largest), largest);
+    }
+
+    SPMDIntegrator::SPMDIntegrator(const Scene& scene)
+        : mScene(scene)
+        , mRandom(_SeedLanes())
+    {
+
+    }
+
+    Vector8 SPMDIntegrator::RandomUnit()
+    {
+        // same distribution as Vector::RandomUnit
+        const Float8 twoPi(6.28318530718f);
+        const Float8 pi(3.14159265359f);
+        const auto azimuth = mRandom.Next() * twoPi - pi;
+        const auto polar = mRandom.Next() * twoPi - pi;
+        Float8 sinAzimuth, cosAzimuth, sinPolar, cosPolar;
+        Float8::SinCos(azimuth, sinAzimuth, cosAzimuth);
+        Float8::SinCos(polar, sinPolar, cosPolar);
+        return { sinPolar * cosAzimuth, sinPolar * sinAzimuth, cosPolar };
+    }
+
+    void SPMDIntegrator::Trace(const RayPacket<kWidth>& primaryRays, std::array<Color, kWidth>& outColors)
+    {
+        using Mask = RayPacket<kWidth>::Mask;
+
+        RayPacket<kWidth> packet = primaryRays;
+        Vector8 throughput = { Float8(1.f), Float8(1.f), Float8(1.f) };
+        Vector8 radiance = { Float8(0.f), Float8(0.f), Float8(0.f) };
+        // type of the surface each lane last scattered off, see PathStats.h
+        std::array<uint8_t, kWidth> lastMaterials;
+        lastMaterials.fill(static_cast<uint8_t>(kNoMaterial));
+        // counts the end of each path in lanes
+        const auto countPaths = [&](Mask lanes, PathEnd end, size_t bounces)
+        {
+            for (size_t lane = 0; lane < kWidth; ++lane)
+            {
+                if ((lanes & (Mask(1) << lane)) != 0)
+                {
+                    RTX_WEEKEND_COUNT_PATH(end, lastMaterials[lane], bounces);
+                }
+            }
+        };
+
+        // paths still alive after the last bounce stay black, as in rayColor
+        for (int depth = kMaxRayDepth; depth > 0 && packet.active != 0; --depth)
+        {
+            if (depth == kMaxRayDepth)
+            {
+                RTX_WEEKEND_COUNT(cameraRays, std::popcount(packet.active));
+            }
+            else
+            {
+                RTX_WEEKEND_COUNT(bounceRays, std::popcount(packet.active));
+            }
+
+            std::array<std::optional<SceneHit>, kWidth> hits;
+            mScene.IntersectPacket(packet, hits);
+
+            // gather the hits into lanes
+            alignas(32) std::array<float, kWidth> pointX = {}, pointY = {}, pointZ = {};
+            alignas(32) std::array<float, kWidth> normalX = {}, normalY = {}, normalZ = {};
+            alignas(32) std::array<float, kWidth> albedoX = {}, albedoY = {}, albedoZ = {};
+            alignas(32) std::array<float, kWidth> ior = {};
+            Mask diffuse = 0;
+            Mask metal = 0;
+            Mask dielectric = 0;
+            for (size_t lane = 0; lane < kWidth; ++lane)
+            {
+                if (!hits[lane].has_value())
+                {
+                    continue;
+                }
+
+                const auto& record = hits[lane]->record;
+                const auto& material = *hits[lane]->material;
+
+                pointX[lane] = record.point.X();
+                pointY[lane] = record.point.Y();
+                pointZ[lane] = record.point.Z();
+                normalX[lane] = record.normal.X();
+                normalY[lane] = record.normal.Y();
+                normalZ[lane] = record.normal.Z();
+                const auto albedo = material.getAlbedo();
+                albedoX[lane] = albedo.X();
+                albedoY[lane] = albedo.Y();
+                albedoZ[lane] = albedo.Z();
+                ior[lane] = static_cast<float>(material.getIOR());
+
+                lastMaterials[lane] = static_cast<uint8_t>(material.getType());
+
+                const Mask bit = Mask(1) << lane;
+                switch (material.getType())
+                {
+                case MaterialType::Diffuse:
+                    diffuse |= bit;
+                    break;
+                case MaterialType::Metal:
+                    metal |= bit;
+                    break;
+                case MaterialType::Dielectric:
+                    dielectric |= bit;
+                    break;
+                }
+            }
+
+            const auto direction = _Load(packet.directionX, packet.directionY, packet.directionZ);
+            const auto point = _Load(pointX, pointY, pointZ);
+            const auto normal = _Load(normalX, normalY, normalZ);
+            const auto albedo = _Load(albedoX, albedoY, albedoZ);
+
+            // misses end on the sky
+            const Mask hit = diffuse | metal | dielectric;
+            const Mask missed = packet.active & ~Mask(hit);
+            if (missed != 0)
+            {
+                countPaths(missed, PathEnd::Sky, kMaxRayDepth - depth);
+                const auto t = (direction.y + Float8(1.f)) * Float8(0.5f);
+                const Vector8 sky1 = { Float8(kSkyColor1.X()), Float8(kSkyColor1.Y()), Float8(kSkyColor1.Z()) };
+                const Vector8 sky2 = { Float8(kSkyColor2.X()), Float8(kSkyColor2.Y()), Float8(kSkyColor2.Z()) };
+                const auto sky = sky1 * (Float8(1.f) - t) + sky2 * t;
+                radiance = Vector8::Select(Float8::FromMask(missed), throughput * sky, radiance);
+            }
+
+            Vector8 scatteredOrigin = point;
+            Vector8 scatteredDirection = direction;
+            Mask continuing = 0;
+
+            if (diffuse != 0)
+            {
+                const auto lanes = Float8::FromMask(diffuse);
+                scatteredDirection = Vector8::Select(lanes, normal + RandomUnit(), scatteredDirection);
+                continuing |= diffuse;
+            }
+
+            if (metal != 0)
+            {
+                const auto lanes = Float8::FromMask(metal);
+                const auto reflected = Vector8::Reflect(direction, normal);
+                const auto goodReflect = lanes & (Vector8::Dot(reflected, normal) > Float8(0.f));
+                scatteredOrigin = Vector8::Select(lanes, point + reflected * Float8(0.001f), scatteredOrigin);
+                scatteredDirection = Vector8::Select(lanes, reflected, scatteredDirection);
+                continuing |= goodReflect.MoveMask();
+
+                // see Scatter, failed reflections end blue
+                const Mask failed = metal & ~goodReflect.MoveMask();
+                if (failed != 0)
+                {
+                    countPaths(failed, PathEnd::FailedReflection, kMaxRayDepth - depth);
+                    const Vector8 blue = { Float8(0.f), Float8(0.f), Float8(1.f) };
+                    radiance = Vector8::Select(Float8::FromMask(failed), throughput * blue, radiance);
+                }
+            }
+
+            if (dielectric != 0)
+            {
+                // see Vector::Refract, rays leaving the surface swap the indices
+                const auto lanes = Float8::FromMask(dielectric);
+                const auto incidentDotNormal = Vector8::Dot(direction, normal.Normalized());
+                const auto leaving = incidentDotNormal > Float8(0.f);
+                const auto materialIOR = Float8::Load(ior);
+                const Float8 airIOR(static_cast<float>(kIORAir));
+                const auto eta = Float8::Select(leaving, materialIOR, airIOR) / Float8::Select(leaving, airIOR, materialIOR);
+                const auto k = Float8(1.f) - eta * eta * (Float8(1.f) - incidentDotNormal * incidentDotNormal);
+
+                auto f0 = (Float8(1.f) - eta) / (Float8(1.f) + eta);
+                f0 = f0 * f0;
+                const auto oneMinusCos = Float8(1.f) - Float8::Abs(incidentDotNormal);
+                const auto oneMinusCos2 = oneMinusCos * oneMinusCos;
+                const auto reflectProbability = f0 + (Float8(1.f) - f0) * oneMinusCos2 * oneMinusCos2 * oneMinusCos;
+
+                const auto reflect = (k < Float8(0.f)) | (mRandom.Next() < reflectProbability);
+                const auto refracted = direction * eta +
+                    normal * (eta * incidentDotNormal - Float8::Sqrt(Float8::Max(k, Float8(0.f))));
+                const auto scattered = Vector8::Select(reflect, Vector8::Reflect(direction, normal), refracted);
+
+                scatteredOrigin = Vector8::Select(lanes, point + scattered * Float8(0.001f), scatteredOrigin);
+                scatteredDirection = Vector8::Select(lanes, scattered, scatteredDirection);
+                continuing |= dielectric;
+            }
+
+            // every scatter attenuates by the albedo
+            throughput = Vector8::Select(Float8::FromMask(hit), throughput * albedo, throughput);
+
+            // the scattered rays become the next packet, directions normalized like Ray's
+            const auto inverseLength = Float8(1.f) / Float8::Sqrt(Vector8::Dot(scatteredDirection, scatteredDirection));
+            scatteredDirection = scatteredDirection * inverseLength;
+            scatteredOrigin.x.Store(packet.originX);
+            scatteredOrigin.y.Store(packet.originY);
+            scatteredOrigin.z.Store(packet.originZ);
+            scatteredDirection.x.Store(packet.directionX);
+            scatteredDirection.y.Store(packet.directionY);
+            scatteredDirection.z.Store(packet.directionZ);
+            _SlabInverse(scatteredDirection.x).Store(packet.inverseDirectionX);
+            _SlabInverse(scatteredDirection.y).Store(packet.inverseDirectionY);
+            _SlabInverse(scatteredDirection.z).Store(packet.inverseDirectionZ);
+            packet.active = continuing;
+        }
+        countPaths(packet.active, PathEnd::DepthLimit, kMaxRayDepth);
+
+        alignas(32) std::array<float, kWidth> red, green, blue;
+        radiance.x.Store(red);
+        radiance.y.Store(green);
+        radiance.z.Store(blue);
+        for (size_t lane = 0; lane < kWidth; ++lane)
+        {
+            outColors[lane] = primaryRays.IsActive(lane) ? Color(red[lane], green[lane], blue[lane]) : Color(0.f, 0.f, 0.f);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef RTX_WEEKEND_SPMDINTEGRATOR_H
+#define RTX_WEEKEND_SPMDINTEGRATOR_H
+
+#if defined(__AVX2__)
+
+#include <array>
+
+#include "Float8.h"
+#include "RayPacket.h"
+#include "Scene.h"
+#include "Integrator.h"
+
+namespace hvk
+{
+    // Traces eight independent paths at once, one per AVX2 lane, typically
+    // from eight different pixels. Each bounce the live lanes are intersected
+    // as one packet and then scattered together, with every material's
+    // scatter evaluated across the lanes and blended by material mask, so all
+    // lanes keep doing useful work until their paths end.
+    class SPMDIntegrator
+    {
+    public:
+        static constexpr size_t kWidth = 8;
+
+        explicit SPMDIntegrator(const Scene& scene);
+
+        // outColors[lane] receives the color of the path started by the
+        // packet's ray in that lane. Inactive lanes come back black.
+        void Trace(const RayPacket<kWidth>& primaryRays, std::array<Color, kWidth>& outColors);
+
+    private:
+        Vector8 RandomUnit();
+
+        const Scene& mScene;
+        Random8 mRandom;
+    };
+}
+
+#endif
+
+#endif //RTX_WEEKEND_SPMDINTEGRATOR_H
@@ -0,0 +1,513 @@
+#include "Scene.h"
+
+#include <limits>
+
+#include "hittest.h"
+#include "Hash.h"
+#include "Trace.h"
+
+namespace hvk
+{
+    Scene::Scene(entt::registry& registry)
+        : mRegistry(registry)
+        , mBuildQuality(BVHBuildQuality::High)
+        , mEntityPrimitives()
+        , mBuildCost(0.f)
+        , mNeedsRebuild(false)
+        , mNeedsRefit(false)
+        , mInstancesChanged(false)
+        , mPlanesChanged(false)
+        , mWorldGeometry()
+        , mInstances()
+        , mInstanceFirstPrimitiveIds()
+        , mFirstPlaneId(0)
+        , mTopLevel()
+        , mPlanes()
+        , mPlaneMaterials()
+    {
+        mRegistry.on_update<Sphere>().connect<&Scene::OnSphereUpdated>(*this);
+        mRegistry.on_update<Box>().connect<&Scene::OnBoxUpdated>(*this);
+        mRegistry.on_update<Quad>().connect<&Scene::OnQuadUpdated>(*this);
+        mRegistry.on_update<Disc>().connect<&Scene::OnDiscUpdated>(*this);
+        mRegistry.on_update<Material>().connect<&Scene::OnMaterialUpdated>(*this);
+
+        mRegistry.on_construct<Sphere>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_destroy<Sphere>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_construct<Box>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_destroy<Box>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_construct<Quad>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_destroy<Quad>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_construct<Disc>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_destroy<Disc>().connect<&Scene::OnGeometryChanged>(*this);
+        mRegistry.on_construct<Material>().connect<&Scene::OnMaterialAdded>(*this);
+        mRegistry.on_destroy<Material>().connect<&Scene::OnMaterialRemoved>(*this);
+
+        mRegistry.on_construct<Instance>().connect<&Scene::OnInstanceChanged>(*this);
+        mRegistry.on_update<Instance>().connect<&Scene::OnInstanceChanged>(*this);
+        mRegistry.on_destroy<Instance>().connect<&Scene::OnInstanceChanged>(*this);
+
+        mRegistry.on_construct<Plane>().connect<&Scene::OnPlanesChanged>(*this);
+        mRegistry.on_update<Plane>().connect<&Scene::OnPlanesChanged>(*this);
+        mRegistry.on_destroy<Plane>().connect<&Scene::OnPlanesChanged>(*this);
+    }
+
+    Scene::~Scene()
+    {
+        mRegistry.on_update<Sphere>().disconnect(*this);
+        mRegistry.on_update<Box>().disconnect(*this);
+        mRegistry.on_update<Quad>().disconnect(*this);
+        mRegistry.on_update<Disc>().disconnect(*this);
+        mRegistry.on_update<Material>().disconnect(*this);
+        mRegistry.on_construct<Sphere>().disconnect(*this);
+        mRegistry.on_destroy<Sphere>().disconnect(*this);
+        mRegistry.on_construct<Box>().disconnect(*this);
+        mRegistry.on_destroy<Box>().disconnect(*this);
+        mRegistry.on_construct<Quad>().disconnect(*this);
+        mRegistry.on_destroy<Quad>().disconnect(*this);
+        mRegistry.on_construct<Disc>().disconnect(*this);
+        mRegistry.on_destroy<Disc>().disconnect(*this);
+        mRegistry.on_construct<Material>().disconnect(*this);
+        mRegistry.on_destroy<Material>().disconnect(*this);
+        mRegistry.on_construct<Instance>().disconnect(*this);
+        mRegistry.on_update<Instance>().disconnect(*this);
+        mRegistry.on_destroy<Instance>().disconnect(*this);
+        mRegistry.on_construct<Plane>().disconnect(*this);
+        mRegistry.on_update<Plane>().disconnect(*this);
+        mRegistry.on_destroy<Plane>().disconnect(*this);
+    }
+
+    void Scene::Build(ThreadPool* pool, BVHBuildQuality quality)
+    {
+        RTX_WEEKEND_TRACE_SCOPE("Scene build");
+        mBuildQuality = quality;
+        mWorldGeometry = std::make_shared<Geometry>();
+        mEntityPrimitives.clear();
+
+        auto sphereView = mRegistry.view<Sphere, Material>();
+        for (const auto entity : sphereView)
+        {
+            mEntityPrimitives[entity] = mWorldGeometry->AddSphere(
+                sphereView.get<Sphere>(entity),
+                sphereView.get<Material>(entity));
+        }
+
+        auto boxView = mRegistry.view<Box, Material>();
+        for (const auto entity : boxView)
+        {
+            mEntityPrimitives[entity] = mWorldGeometry->AddBox(
+                boxView.get<Box>(entity),
+                boxView.get<Material>(entity));
+        }
+
+        auto quadView = mRegistry.view<Quad, Material>();
+        for (const auto entity : quadView)
+        {
+            mEntityPrimitives[entity] = mWorldGeometry->AddQuad(
+                quadView.get<Quad>(entity),
+                quadView.get<Material>(entity));
+        }
+
+        auto discView = mRegistry.view<Disc, Material>();
+        for (const auto entity : discView)
+        {
+            mEntityPrimitives[entity] = mWorldGeometry->AddDisc(
+                discView.get<Disc>(entity),
+                discView.get<Material>(entity));
+        }
+
+        mWorldGeometry->Build(pool, quality);
+        mBuildCost = mWorldGeometry->getSAHCost();
+        mNeedsRebuild = false;
+        mNeedsRefit = false;
+        UpdateInstances();
+        GatherPlanes();
+    }
+
+    void Scene::GatherPlanes()
+    {
+        mPlanesChanged = false;
+        mPlanes.clear();
+        mPlaneMaterials.clear();
+        auto planeView = mRegistry.view<Plane, Material>();
+        for (const auto entity : planeView)
+        {
+            mPlanes.push_back(planeView.get<Plane>(entity));
+            mPlaneMaterials.push_back(planeView.get<Material>(entity));
+        }
+    }
+
+    void Scene::Update(ThreadPool* pool)
+    {
+        if (mNeedsRebuild)
+        {
+            Build(pool, mBuildQuality);
+            return;
+        }
+
+        if (mNeedsRefit)
+        {
+            mWorldGeometry->Refit();
+            if (mWorldGeometry->getSAHCost() > kMaxRefitCostRatio * mBuildCost)
+            {
+                mWorldGeometry->Build(pool, mBuildQuality);
+                mBuildCost = mWorldGeometry->getSAHCost();
+            }
+            mNeedsRefit = false;
+            // the world geometry's bounds may have moved
+            mInstancesChanged = true;
+        }
+
+        if (mInstancesChanged)
+        {
+            UpdateInstances();
+        }
+
+        if (mPlanesChanged)
+        {
+            GatherPlanes();
+        }
+    }
+
+    void Scene::OnSphereUpdated(entt::registry& registry, entt::entity entity)
+    {
+        const auto primitive = mEntityPrimitives.find(entity);
+        if (primitive != mEntityPrimitives.end())
+        {
+            mWorldGeometry->SetSphere(primitive->second, registry.get<Sphere>(entity));
+            mNeedsRefit = true;
+        }
+    }
+
+    void Scene::OnBoxUpdated(entt::registry& registry, entt::entity entity)
+    {
+        const auto primitive = mEntityPrimitives.find(entity);
+        if (primitive != mEntityPrimitives.end())
+        {
+            mWorldGeometry->SetBox(primitive->second, registry.get<Box>(entity));
+            mNeedsRefit = true;
+        }
+    }
+
+    void Scene::OnQuadUpdated(entt::registry& registry, entt::entity entity)
+    {
+        const auto primitive = mEntityPrimitives.find(entity);
+        if (primitive != mEntityPrimitives.end())
+        {
+            mWorldGeometry->SetQuad(primitive->second, registry.get<Quad>(entity));
+            mNeedsRefit = true;
+        }
+    }
+
+    void Scene::OnDiscUpdated(entt::registry& registry, entt::entity entity)
+    {
+        const auto primitive = mEntityPrimitives.find(entity);
+        if (primitive != mEntityPrimitives.end())
+        {
+            mWorldGeometry->SetDisc(primitive->second, registry.get<Disc>(entity));
+            mNeedsRefit = true;
+        }
+    }
+
+    void Scene::OnMaterialUpdated(entt::registry& registry, entt::entity entity)
+    {
+        const auto primitive = mEntityPrimitives.find(entity);
+        if (primitive != mEntityPrimitives.end())
+        {
+            mWorldGeometry->SetMaterial(primitive->second, registry.get<Material>(entity));
+        }
+        else if (registry.has<Plane>(entity))
+        {
+            mPlanesChanged = true;
+        }
+    }
+
+    void Scene::OnMaterialAdded(entt::registry& registry, entt::entity entity)
+    {
+        // a shape only joins the scene once it has a material
+        if (registry.any<Sphere, Box, Quad, Disc>(entity))
+        {
+            mNeedsRebuild = true;
+        }
+        else if (registry.has<Plane>(entity))
+        {
+            mPlanesChanged = true;
+        }
+    }
+
+    void Scene::OnMaterialRemoved(entt::registry& registry, entt::entity entity)
+    {
+        // and leaves it with its material
+        if (mEntityPrimitives.find(entity) != mEntityPrimitives.end())
+        {
+            mNeedsRebuild = true;
+        }
+        else if (registry.has<Plane>(entity))
+        {
+            mPlanesChanged = true;
+        }
+    }
+
+    void Scene::OnGeometryChanged(entt::registry& registry, entt::entity entity)
+    {
+        // the set of primitives changed, which a refit can't express
+        mNeedsRebuild = true;
+    }
+
+    void Scene::OnInstanceChanged(entt::registry& registry, entt::entity entity)
+    {
+        mInstancesChanged = true;
+    }
+
+    void Scene::OnPlanesChanged(entt::registry& registry, entt::entity entity)
+    {
+        mPlanesChanged = true;
+    }
+
+    void Scene::UpdateInstances()
+    {
+        mInstancesChanged = false;
+        mInstances.clear();
+        mInstanceFirstPrimitiveIds.clear();
+        if (mWorldGeometry && mWorldGeometry->getNumPrimitives() > 0)
+        {
+            mInstances.push_back(Instance{ mWorldGeometry, Transform() });
+        }
+
+        auto instanceView = mRegistry.view<Instance>();
+        for (const auto entity : instanceView)
+        {
+            const auto& instance = instanceView.get(entity);
+            if (instance.geometry && instance.geometry->getNumPrimitives() > 0)
+            {
+                mInstances.push_back(instance);
+            }
+        }
+
+        mFirstPlaneId = 0;
+        for (const auto& instance : mInstances)
+        {
+            mInstanceFirstPrimitiveIds.push_back(mFirstPlaneId);
+            mFirstPlaneId += static_cast<uint32_t>(instance.geometry->getNumPrimitives());
+        }
+
+        BuildTopLevel();
+    }
+
+    void Scene::BuildTopLevel()
+    {
+        RTX_WEEKEND_TRACE_SCOPE("Top level build");
+        std::vector<AABB> instanceBounds;
+        instanceBounds.reserve(mInstances.size());
+        for (const auto& instance : mInstances)
+        {
+            instanceBounds.push_back(instance.transform.TransformBounds(instance.geometry->getBounds()));
+        }
+        mTopLevel.Build(instanceBounds);
+    }
+
+    AABB Scene::getBounds() const
+    {
+        return mTopLevel.getBounds();
+    }
+
+    uint64_t Scene::getHash() const
+    {
+        uint64_t hash = hash::kFnvOffset;
+        for (const auto& instance : mInstances)
+        {
+            const uint64_t geometryHash = instance.geometry->getHash();
+            hash = hash::Combine(hash, &geometryHash, sizeof(geometryHash));
+            // where the transform takes the origin and the axes pins it down
+            const auto& transform = instance.transform;
+            hash = hash::Combine(hash, transform.TransformPoint(Vector(0.f, 0.f, 0.f)));
+            hash = hash::Combine(hash, transform.TransformPoint(Vector(1.f, 0.f, 0.f)));
+            hash = hash::Combine(hash, transform.TransformPoint(Vector(0.f, 1.f, 0.f)));
+            hash = hash::Combine(hash, transform.TransformPoint(Vector(0.f, 0.f, 1.f)));
+        }
+        for (size_t i = 0; i < mPlanes.size(); ++i)
+        {
+            hash = hash::Combine(hash, mPlanes[i].getOrigin());
+            hash = hash::Combine(hash, mPlanes[i].getDirection());
+            hash = hash::Combine(hash, static_cast<uint32_t>(mPlaneMaterials[i].getType()));
+            hash = hash::Combine(hash, mPlaneMaterials[i].getAlbedo());
+            hash = hash::Combine(hash, static_cast<float>(mPlaneMaterials[i].getIOR()));
+        }
+        return hash;
+    }
+
+    std::optional<SceneHit> Scene::Intersect(const Ray& ray) const
+    {
+        SceneHit closestHit = {};
+        closestHit.material = nullptr;
+        float tMax = std::numeric_limits<float>::max();
+
+        mTopLevel.Intersect(ray, tMax, [&](uint32_t instanceIndex, float& closest) {
+            const auto& instance = mInstances[instanceIndex];
+            const auto& transform = instance.transform;
+            HitRecord record = {};
+            const Material* material = nullptr;
+            uint32_t primitive = 0;
+            if (transform.IsIdentity())
+            {
+                if (instance.geometry->Intersect(ray, closest, record, material, primitive))
+                {
+                    closestHit.record = record;
+                    closestHit.material = material;
+                    closestHit.primitiveId = mInstanceFirstPrimitiveIds[instanceIndex] + primitive;
+                }
+                return;
+            }
+
+            // trace in the geometry's object space, where distances are
+            // scaled down by the instance's uniform scale
+            const float scale = transform.getScale();
+            const Ray objectRay(
+                transform.InverseTransformPoint(ray.getOrigin()),
+                transform.InverseTransformDirection(ray.getDirection()));
+            float objectTMax = closest / scale;
+            if (instance.geometry->Intersect(objectRay, objectTMax, record, material, primitive))
+            {
+                record.t = record.t * scale;
+                record.point = transform.TransformPoint(record.point);
+                record.normal = transform.TransformDirection(record.normal);
+                closest = static_cast<float>(record.t);
+                closestHit.record = record;
+                closestHit.material = material;
+                closestHit.primitiveId = mInstanceFirstPrimitiveIds[instanceIndex] + primitive;
+            }
+        });
+
+        // unbounded, so tested once per ray rather than through the BVH
+        for (size_t i = 0; i < mPlanes.size(); ++i)
+        {
+            const auto& plane = mPlanes[i];
+            auto intersection = hit::PlaneRayIntersect(plane, ray);
+            if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < tMax)
+            {
+                tMax = static_cast<float>(intersection.value());
+                closestHit.record.t = intersection.value();
+                closestHit.record.point = ray.PointAt(closestHit.record.t);
+                closestHit.record.normal = plane.getDirection().Normalized();
+                closestHit.material = &mPlaneMaterials[i];
+                closestHit.primitiveId = mFirstPlaneId + static_cast<uint32_t>(i);
+            }
+        }
+
+        if (closestHit.material == nullptr)
+        {
+            return std::nullopt;
+        }
+        return std::optional{ closestHit };
+    }
+
+    template <size_t N>
+    void Scene::IntersectPacket(const RayPacket<N>& packet, std::array<std::optional<SceneHit>, N>& outHits) const
+    {
+        using Mask = typename RayPacket<N>::Mask;
+        outHits.fill(std::nullopt);
+        if (!packet.IsCoherent())
+        {
+            for (size_t lane = 0; lane < N; ++lane)
+            {
+                if (packet.IsActive(lane))
+                {
+                    outHits[lane] = Intersect(packet.GetRay(lane));
+                }
+            }
+            return;
+        }
+
+        std::array<float, N> tMax;
+        tMax.fill(std::numeric_limits<float>::max());
+        std::array<HitRecord, N> records = {};
+        std::array<const Material*, N> materials = {};
+        std::array<uint32_t, N> primitiveIds = {};
+
+        mTopLevel.IntersectPacket(packet, packet.active, tMax, [&](uint32_t instanceIndex, Mask lanes, std::array<float, N>& closest) {
+            const auto& instance = mInstances[instanceIndex];
+            const auto& transform = instance.transform;
+            std::array<uint32_t, N> primitives = {};
+            if (transform.IsIdentity())
+            {
+                // the geometry lowers closest only in the lanes it hit
+                const auto previousClosest = closest;
+                instance.geometry->IntersectPacket(packet, lanes, closest, records, materials, primitives);
+                for (size_t lane = 0; lane < N; ++lane)
+                {
+                    if (closest[lane] < previousClosest[lane])
+                    {
+                        primitiveIds[lane] = mInstanceFirstPrimitiveIds[instanceIndex] + primitives[lane];
+                    }
+                }
+                return;
+            }
+
+            // move the lanes into the geometry's object space, see Intersect
+            const float scale = transform.getScale();
+            RayPacket<N> objectPacket;
+            std::array<float, N> objectTMax = {};
+            std::array<HitRecord, N> objectRecords = {};
+            std::array<const Material*, N> objectMaterials = {};
+            for (size_t lane = 0; lane < N; ++lane)
+            {
+                if ((lanes & (Mask(1) << lane)) != 0)
+                {
+                    const auto ray = packet.GetRay(lane);
+                    objectPacket.Set(lane, Ray(
+                        transform.InverseTransformPoint(ray.getOrigin()),
+                        transform.InverseTransformDirection(ray.getDirection())));
+                    objectTMax[lane] = closest[lane] / scale;
+                }
+            }
+
+            instance.geometry->IntersectPacket(objectPacket, lanes, objectTMax, objectRecords, objectMaterials, primitives);
+            for (size_t lane = 0; lane < N; ++lane)
+            {
+                if (objectMaterials[lane] != nullptr)
+                {
+                    auto& record = records[lane];
+                    record = objectRecords[lane];
+                    record.t = record.t * scale;
+                    record.point = transform.TransformPoint(record.point);
+                    record.normal = transform.TransformDirection(record.normal);
+                    closest[lane] = static_cast<float>(record.t);
+                    materials[lane] = objectMaterials[lane];
+                    primitiveIds[lane] = mInstanceFirstPrimitiveIds[instanceIndex] + primitives[lane];
+                }
+            }
+        });
+
+        for (size_t lane = 0; lane < N; ++lane)
+        {
+            if (!packet.IsActive(lane))
+            {
+                continue;
+            }
+
+            const auto ray = packet.GetRay(lane);
+            for (size_t i = 0; i < mPlanes.size(); ++i)
+            {
+                const auto& plane = mPlanes[i];
+                auto intersection = hit::PlaneRayIntersect(plane, ray);
+                if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < tMax[lane])
+                {
+                    tMax[lane] = static_cast<float>(intersection.value());
+                    records[lane].t = intersection.value();
+                    records[lane].point = ray.PointAt(records[lane].t);
+                    records[lane].normal = plane.getDirection().Normalized();
+                    materials[lane] = &mPlaneMaterials[i];
+                    primitiveIds[lane] = mFirstPlaneId + static_cast<uint32_t>(i);
+                }
+            }
+
+            if (materials[lane] != nullptr)
+            {
+                outHits[lane] = SceneHit{ records[lane], materials[lane], primitiveIds[lane] };
+            }
+        }
+    }
+
+    template void Scene::IntersectPacket<4>(const RayPacket<4>&, std::array<std::optional<SceneHit>, 4>&) const;
+    template void Scene::IntersectPacket<8>(const RayPacket<8>&, std::array<std::optional<SceneHit>, 8>&) const;
+    template void Scene::IntersectPacket<16>(const RayPacket<16>&, std::array<std::optional<SceneHit>, 16>&) const;
+}
@@ -0,0 +1,110 @@
+#ifndef RTX_WEEKEND_SCENE_H
+#define RTX_WEEKEND_SCENE_H
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "Ray.h"
+#include "Material.h"
+#include "HitRecord.h"
+#include "Geometry.h"
+#include "Instance.h"
+#include "BVH.h"
+#include "ThreadPool.h"
+#include "RayPacket.h"
+
+namespace hvk
+{
+    struct SceneHit
+    {
+        HitRecord record;
+        const Material* material;
+        // Unique within the scene. Each instance numbers its primitives after
+        // those of the instances before it, and planes come after all of them.
+        uint32_t primitiveId;
+    };
+
+    // Two level acceleration structure compiled from a registry.
+    // Entities with a Sphere, Box, Quad or Disc (plus Material) are gathered
+    // into a single world Geometry, entities with an Instance reference shared
+    // Geometry, and a top level BVH is built over the world bounds of all of
+    // them. Infinite Planes can't be bounded, so they are kept in a short list
+    // on the side that every ray tests once after the BVH.
+    // The scene listens to the registry's component signals and applies the
+    // changes it hears about on the next call to Update.
+    class Scene
+    {
+    public:
+        explicit Scene(entt::registry& registry);
+        ~Scene();
+        Scene(const Scene&) = delete;
+        Scene& operator= (const Scene&) = delete;
+
+        // rebuilds everything, bottom level included. The pool, if any, is
+        // used for the BVH builds and must be idle. The quality applies to the
+        // world geometry; the top level is small and always built with SAH.
+        void Build(ThreadPool* pool = nullptr, BVHBuildQuality quality = BVHBuildQuality::High);
+        // re-reads instance transforms and rebuilds only the top level
+        void UpdateInstances();
+        // Brings the acceleration structures up to date with the registry.
+        // Patched bounded primitives are refit in place; added or removed ones,
+        // or refits that push the SAH cost too far past that of the last
+        // build, cause a rebuild. Must not be called while rendering.
+        void Update(ThreadPool* pool = nullptr);
+
+        // bounds of everything but the planes
+        AABB getBounds() const;
+        // Of every instance's geometry and placement and every plane, so that
+        // processes rendering parts of one image can check they agree on it
+        uint64_t getHash() const;
+
+        std::optional<SceneHit> Intersect(const Ray& ray) const;
+        // Intersects every active ray of the packet. Coherent packets share
+        // their traversal of both BVH levels; incoherent ones fall back to
+        // tracing each ray on its own.
+        template <size_t N>
+        void IntersectPacket(const RayPacket<N>& packet, std::array<std::optional<SceneHit>, N>& outHits) const;
+
+    private:
+        // rebuild once refitting makes tracing this much more expensive
+        static constexpr float kMaxRefitCostRatio = 1.5f;
+
+        void BuildTopLevel();
+        void GatherPlanes();
+
+        void OnSphereUpdated(entt::registry& registry, entt::entity entity);
+        void OnBoxUpdated(entt::registry& registry, entt::entity entity);
+        void OnQuadUpdated(entt::registry& registry, entt::entity entity);
+        void OnDiscUpdated(entt::registry& registry, entt::entity entity);
+        void OnPlanesChanged(entt::registry& registry, entt::entity entity);
+        void OnMaterialUpdated(entt::registry& registry, entt::entity entity);
+        void OnMaterialAdded(entt::registry& registry, entt::entity entity);
+        void OnMaterialRemoved(entt::registry& registry, entt::entity entity);
+        void OnGeometryChanged(entt::registry& registry, entt::entity entity);
+        void OnInstanceChanged(entt::registry& registry, entt::entity entity);
+
+        entt::registry& mRegistry;
+        BVHBuildQuality mBuildQuality;
+        std::unordered_map<entt::entity, uint32_t> mEntityPrimitives;
+        float mBuildCost;
+        bool mNeedsRebuild;
+        bool mNeedsRefit;
+        bool mInstancesChanged;
+        bool mPlanesChanged;
+        std::shared_ptr<Geometry> mWorldGeometry;
+        std::vector<Instance> mInstances;
+        // primitive id of each instance's first primitive, see SceneHit
+        std::vector<uint32_t> mInstanceFirstPrimitiveIds;
+        uint32_t mFirstPlaneId;
+        BVH mTopLevel;
+        std::vector<Plane> mPlanes;
+        std::vector<Material> mPlaneMaterials;
+    };
+}
+
+#endif //RTX_WEEKEND_SCENE_H
@@ -0,0 +1,272 @@
+#include "Scenes.h"
+
+#include <random>
+
+#include "Sphere.h"
+#include "Plane.h"
+#include "Box.h"
+#include "Material.h"
+
+namespace hvk
+{
+    namespace scenes
+    {
+        // an axis aligned box from its center and half its size along each axis
+        void _AddBox(entt::registry& registry, const Vector& center, const Vector& halfSize, const Material& material)
+        {
+            const auto entity = registry.create();
+            registry.emplace<Box>(
+                    entity,
+                    Plane(center + Vector(0.f, halfSize.Y(), 0.f), Vector(0.f, 1.f, 0.f)), // top
+                    Plane(center - Vector(0.f, halfSize.Y(), 0.f), Vector(0.f, -1.f, 0.f)), // bottom
+                    Plane(center + Vector(0.f, 0.f, halfSize.Z()), Vector(0.f, 0.f, 1.f)), // front
+                    Plane(center - Vector(0.f, 0.f, halfSize.Z()), Vector(0.f, 0.f, -1.f)), // back
+                    Plane(center - Vector(halfSize.X(), 0.f, 0.f), Vector(-1.f, 0.f, 0.f)), // left
+                    Plane(center + Vector(halfSize.X(), 0.f, 0.f), Vector(1.f, 0.f, 0.f))); // right
+            registry.emplace<Material>(entity, material);
+        }
+
+        void _AddSphere(entt::registry& registry, const Vector& center, float radius, const Material& material)
+        {
+            const auto entity = registry.create();
+            registry.emplace<Sphere>(entity, center, radius);
+            registry.emplace<Material>(entity, material);
+        }
+
+        void _AddGround(entt::registry& registry, float height, const Color& albedo)
+        {
+            const auto entity = registry.create();
+            registry.emplace<Plane>(entity, Vector(0.f, height, 0.f), Vector(0.f, 1.f, 0.f));
+            registry.emplace<Material>(entity, MaterialType::Diffuse, albedo, -1.f);
+        }
+
+        Camera Demo(entt::registry& registry, Real aspectRatio)
+        {
+            auto sphereEntity = registry.create();
+            registry.emplace<Sphere>(sphereEntity, Vector(0.0f, 0.0f, -1.f), 0.5f);
+            registry.emplace<Material>(sphereEntity, MaterialType::Diffuse, Color(1.f, 0.f, 0.f), -1.f);
+
+//            auto groundEntity = registry.create();
+//            registry.emplace<Sphere>(groundEntity, Vector(0, -100.5f, -1.f), 100.f);
+//            registry.emplace<Material>(groundEntity, MaterialType::Diffuse, Color(0.f, 1.f, 0.f), -1.f);
+
+//            auto metalSphere1 = registry.create();
+//            registry.emplace<Sphere>(metalSphere1, Vector(-1.0f, 0.f, -1.f), 0.5f);
+//            registry.emplace<Material>(metalSphere1, MaterialType::Metal, Color(1.f, 1.f, 1.f));
+
+            auto metalSphere2 = registry.create();
+            registry.emplace<Sphere>(metalSphere2, Vector(1.0f, 0.f, -1.f), 0.5f);
+            registry.emplace<Material>(metalSphere2, MaterialType::Metal, Color(1.f, 1.f, 1.f), -1.f);
+
+            auto behindSphere = registry.create();
+            registry.emplace<Sphere>(behindSphere, Vector(0.5f, 0.0f, 1.f), 0.5f);
+            registry.emplace<Material>(behindSphere, MaterialType::Diffuse, Color(1.f, 0.f, 1.f), -1.f);
+
+            auto glassSphere = registry.create();
+            registry.emplace<Sphere>(glassSphere, Vector(2.f, 0.f, -1.f), 0.5f);
+            registry.emplace<Material>(glassSphere, MaterialType::Dielectric, Color(0.8f, 0.8f, 0.8f), 1.5);
+
+            auto smallGlass = registry.create();
+            registry.emplace<Sphere>(smallGlass, Vector(0.3f, -.3f, -0.4f), 0.2f);
+            registry.emplace<Material>(smallGlass, MaterialType::Dielectric, Color(1.f, 1.f, 1.f), 1.5);
+
+            auto smallGlass2 = registry.create();
+            registry.emplace<Sphere>(smallGlass2, Vector(-0.32f, -.3f, -0.42f), 0.2f);
+            registry.emplace<Material>(smallGlass2, MaterialType::Dielectric, Color(1.f, 1.f, 1.f), 1.5);
+
+            auto smallMetalSphere = registry.create();
+            registry.emplace<Sphere>(smallMetalSphere, Vector(-0.68f, -.3f, -0.69f), 0.25f);
+            registry.emplace<Material>(smallMetalSphere, MaterialType::Metal, Color(0.7f, 0.2f, 0.7f), -1.f);
+
+            auto groundPlane = registry.create();
+            registry.emplace<Plane>(groundPlane, Vector(0.f, -0.5f, 0.f), Vector(0.f, 1.f, 0.f));
+            registry.emplace<Material>(groundPlane, MaterialType::Diffuse, Color(0.8f, 0.8f, 0.8f), -1.f);
+
+            auto smallMetalBox = registry.create();
+            registry.emplace<Box>(
+                    smallMetalBox,
+                    Plane(Vector(0.f, 0.5f, -4.f), Vector(0.f, 1.f, 0.f)), // top
+                    Plane(Vector(0.f, -0.5f, -4.f), Vector(0.f, -1.f, 0.f)), // bottom
+                    Plane(Vector(0.f, 0.f, -3.5f), Vector(0.f, 0.f, 1.f)), // front
+                    Plane(Vector(0.f, 0.f, -4.5f), Vector(0.f, 0.f, -1.f)), // back
+                    Plane(Vector(-0.5f, 0.f, -4.f), Vector(-1.f, 0.f, 0.f)), // left
+                    Plane(Vector(0.5f, 0.f, -4.f), Vector(1.f, 0.f, 0.f))); // right
+            registry.emplace<Material>(smallMetalBox, MaterialType::Metal, Color(0.8f, 0.6f, 0.1f), -1.f);
+
+            auto glassBox = registry.create();
+            registry.emplace<Box>(
+                    glassBox,
+                    Plane(Vector(-0.5f, 0.0f, -2.5f), Vector(0.f, 1.f, 0.f)), // top
+                    Plane(Vector(-0.5f, -0.5f, -2.5f), Vector(0.f, -1.f, 0.f)), // bottom
+                    Plane(Vector(-0.5f, -0.25f, -2.f), Vector(0.f, 0.f, 1.f)), // front
+                    Plane(Vector(-0.5f, -0.25f, -2.5f), Vector(0.f, 0.f, -1.f)), // back
+                    Plane(Vector(-1.f, -0.25f, -2.5f), Vector(-1.f, 0.f, 0.f)), // left
+                    Plane(Vector(-0.5f, -0.25f, -2.5f), Vector(1.f, 0.f, 0.f))); // right
+            registry.emplace<Material>(glassBox, MaterialType::Dielectric, Color(.9f, .9f, .9f), 1.5f);
+
+//            auto diffuseBox = registry.create();
+//            registry.emplace<Box>(
+//                    diffuseBox,
+//                    Plane(Vector(-1.5f, 1.f, -2.f), Vector(0.f, 1.f, 0.f)),
+//                    Plane(Vector(-1.5f, -0.5f, -2.f), Vector(0.f, -1.f, 0.f)),
+//                    Plane(Vector(-1.5f, 0.25f, -1.f), Vector(0.f, 0.f, 1.f)),
+//                    Plane(Vector(-1.5f, 0.25f, -3.f), Vector(0.f, 0.f, -1.f)),
+//                    Plane(Vector(-2.5f, 0.25f, -2.f), Vector(-1.f, 0.f, 0.f)),
+//                    Plane(Vector(-1.f, 0.25f, -2.f), Vector(1.f, 0.f, 0.f)));
+//            registry.emplace<Material>(diffuseBox, MaterialType::Diffuse, Color(0.66, 0.2, 0.8));
+
+            // auto metalBox = registry.create();
+            // registry.emplace<Box>(
+            //         metalBox,
+            //         Plane(Vector(-1.5f, 1.f, -2.f), Vector(0.f, 1.f, 0.f)),
+            //         Plane(Vector(-1.5f, -0.5f, -2.f), Vector(0.f, -1.f, 0.f)),
+            //         Plane(Vector(-1.5f, 0.25f, 0.f), Vector(0.f, 0.f, 1.f)),
+            //         Plane(Vector(-1.5f, 0.25f, -3.f), Vector(0.f, 0.f, -1.f)),
+            //         Plane(Vector(-2.5f, 0.25f, -2.f), Vector(-1.f, 0.f, 0.f)),
+            //         Plane(Vector(-1.f, 0.25f, -2.f), Vector(1.f, 0.f, 0.f)));
+            // registry.emplace<Material>(metalBox, MaterialType::Metal, Color(.8f, .8f, .8f), -1.f);
+
+            return Camera(
+                    Vector(-1.5f, .6f, 0.8f),
+                    Vector(0.f, 0.f, -1.f),
+                    Vector(0.f, 1.f, 0.f),
+                    60.f,
+                    aspectRatio,
+                    0.001f,
+                    2.f);
+        }
+
+        Camera Cover(entt::registry& registry, Real aspectRatio)
+        {
+            // its own generator, the shared one is seeded per render
+            std::mt19937 generator(1);
+            std::uniform_real_distribution<float> random(0.f, 1.f);
+            const auto randomColor = [&](float min, float max)
+            {
+                return Color(
+                        min + (max - min) * random(generator),
+                        min + (max - min) * random(generator),
+                        min + (max - min) * random(generator));
+            };
+
+            _AddGround(registry, 0.f, Color(0.5f, 0.5f, 0.5f));
+
+            const Vector clearing(4.f, 0.2f, 0.f);
+            for (int a = -11; a < 11; ++a)
+            {
+                for (int b = -11; b < 11; ++b)
+                {
+                    const float chooseMaterial = random(generator);
+                    const Vector center(a + 0.9f * random(generator), 0.2f, b + 0.9f * random(generator));
+                    // keep clear of the large metal sphere
+                    const auto offset = center - clearing;
+                    if (Vector::Dot(offset, offset) <= 0.9f * 0.9f)
+                    {
+                        continue;
+                    }
+
+                    if (chooseMaterial < 0.8f)
+                    {
+                        _AddSphere(registry, center, 0.2f,
+                                Material(MaterialType::Diffuse, randomColor(0.f, 1.f) * randomColor(0.f, 1.f), -1.f));
+                    }
+                    else if (chooseMaterial < 0.95f)
+                    {
+                        _AddSphere(registry, center, 0.2f, Material(MaterialType::Metal, randomColor(0.5f, 1.f), -1.f));
+                    }
+                    else
+                    {
+                        _AddSphere(registry, center, 0.2f, Material(MaterialType::Dielectric, Color(1.f, 1.f, 1.f), 1.5f));
+                    }
+                }
+            }
+
+            _AddSphere(registry, Vector(0.f, 1.f, 0.f), 1.f, Material(MaterialType::Dielectric, Color(1.f, 1.f, 1.f), 1.5f));
+            _AddSphere(registry, Vector(-4.f, 1.f, 0.f), 1.f, Material(MaterialType::Diffuse, Color(0.4f, 0.2f, 0.1f), -1.f));
+            _AddSphere(registry, Vector(4.f, 1.f, 0.f), 1.f, Material(MaterialType::Metal, Color(0.7f, 0.6f, 0.5f), -1.f));
+
+            return Camera(
+                    Vector(13.f, 2.f, 3.f),
+                    Vector(0.f, 0.f, 0.f),
+                    Vector(0.f, 1.f, 0.f),
+                    20.f,
+                    aspectRatio,
+                    0.001f,
+                    2.f);
+        }
+
+        Camera Boxes(entt::registry& registry, Real aspectRatio)
+        {
+            std::mt19937 generator(2);
+            std::uniform_real_distribution<float> random(0.f, 1.f);
+
+            _AddGround(registry, 0.f, Color(0.8f, 0.8f, 0.8f));
+
+            // a 12 x 12 grid of boxes of random heights, every fifth metal and every seventh glass
+            const int kGridSize = 12;
+            for (int x = 0; x < kGridSize; ++x)
+            {
+                for (int z = 0; z < kGridSize; ++z)
+                {
+                    const float height = 0.1f + 0.4f * random(generator);
+                    const Vector center(x - kGridSize / 2 + 0.5f, height, -z);
+                    const Vector halfSize(0.35f, height, 0.35f);
+                    const int index = x * kGridSize + z;
+                    if (index % 7 == 0)
+                    {
+                        _AddBox(registry, center, halfSize, Material(MaterialType::Dielectric, Color(0.9f, 0.9f, 0.9f), 1.5f));
+                    }
+                    else if (index % 5 == 0)
+                    {
+                        _AddBox(registry, center, halfSize, Material(MaterialType::Metal, Color(0.8f, 0.6f, 0.2f), -1.f));
+                    }
+                    else
+                    {
+                        const Color albedo(random(generator), random(generator), random(generator));
+                        _AddBox(registry, center, halfSize, Material(MaterialType::Diffuse, albedo, -1.f));
+                    }
+                }
+            }
+
+            return Camera(
+                    Vector(0.f, 4.f, 4.f),
+                    Vector(0.f, 0.f, -5.f),
+                    Vector(0.f, 1.f, 0.f),
+                    50.f,
+                    aspectRatio,
+                    0.001f,
+                    2.f);
+        }
+
+        Camera Glass(entt::registry& registry, Real aspectRatio)
+        {
+            _AddGround(registry, -0.5f, Color(0.8f, 0.8f, 0.8f));
+
+            const Material glass(MaterialType::Dielectric, Color(1.f, 1.f, 1.f), 1.5f);
+
+            // a row of glass spheres before a diffuse backdrop of spheres
+            for (int i = 0; i < 7; ++i)
+            {
+                _AddSphere(registry, Vector(-1.8f + 0.6f * i, -0.25f, -1.f), 0.25f, glass);
+                _AddSphere(registry, Vector(-1.8f + 0.6f * i, -0.2f, -3.f), 0.3f,
+                        Material(MaterialType::Diffuse, Color(0.2f + 0.1f * i, 0.3f, 0.9f - 0.1f * i), -1.f));
+            }
+
+            // glass inside glass, where paths bounce between the surfaces longest
+            _AddSphere(registry, Vector(-0.6f, 0.3f, -2.f), 0.6f, glass);
+            _AddSphere(registry, Vector(-0.6f, 0.3f, -2.f), 0.4f, glass);
+            _AddSphere(registry, Vector(-0.6f, 0.3f, -2.f), 0.2f, Material(MaterialType::Metal, Color(0.9f, 0.9f, 0.9f), -1.f));
+
+            _AddBox(registry, Vector(0.9f, -0.1f, -2.f), Vector(0.4f, 0.4f, 0.4f), glass);
+
+            return Camera(
+                    Vector(0.f, 0.4f, 1.f),
+                    Vector(0.f, -0.1f, -2.f),
+                    Vector(0.f, 1.f, 0.f),
+                    60.f,
+                    aspectRatio,
+                    0.001f,
+                    2.f);
+        }
+    }
+}
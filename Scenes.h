@@ -0,0 +1,46 @@
+#ifndef RTX_WEEKEND_SCENES_H
+#define RTX_WEEKEND_SCENES_H
+
+#include <array>
+
+#include <entt/entt.hpp>
+
+#include "Camera.h"
+#include "Real.h"
+
+namespace hvk
+{
+    namespace scenes
+    {
+        // Each adds its entities to registry and returns the camera to view
+        // them through. Scenes with randomly placed objects draw them from a
+        // fixed seed, so that a scene is the same every time it is built.
+
+        // the spheres, boxes and ground plane rtx_weekend has always rendered
+        Camera Demo(entt::registry& registry, Real aspectRatio);
+        // the final scene of Ray Tracing in One Weekend: hundreds of small
+        // spheres of random materials around three large ones
+        Camera Cover(entt::registry& registry, Real aspectRatio);
+        // a grid of boxes of every material, where box tests dominate
+        Camera Boxes(entt::registry& registry, Real aspectRatio);
+        // glass spheres, nested glass spheres and a glass box, where long
+        // refraction paths dominate
+        Camera Glass(entt::registry& registry, Real aspectRatio);
+
+        struct Canonical
+        {
+            const char* name;
+            Camera (*build)(entt::registry& registry, Real aspectRatio);
+        };
+
+        // the scenes rtx_bench renders, in order
+        const std::array<Canonical, 4> kCanonical = { {
+            { "demo", Demo },
+            { "cover", Cover },
+            { "boxes", Boxes },
+            { "glass", Glass }
+        } };
+    }
+}
+
+#endif //RTX_WEEKEND_SCENES_H
@@ -0,0 +1,213 @@
+#include "Socket.h"
+
+#include <mutex>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace hvk
+{
+#if defined(_WIN32)
+    constexpr uintptr_t kInvalidSocket = INVALID_SOCKET;
+
+    void _CloseSocket(uintptr_t handle)
+    {
+        closesocket(static_cast<SOCKET>(handle));
+    }
+
+    void _Startup()
+    {
+        static std::once_flag started;
+        std::call_once(started, []() {
+            WSADATA data = {};
+            WSAStartup(MAKEWORD(2, 2), &data);
+        });
+    }
+
+    constexpr int kShutdownBoth = SD_BOTH;
+    // sends to a closed peer fail with an error rather than a signal on Windows
+    constexpr int kSendFlags = 0;
+#else
+    constexpr int kInvalidSocket = -1;
+
+    void _CloseSocket(int handle)
+    {
+        close(handle);
+    }
+
+    void _Startup()
+    {
+    }
+
+    constexpr int kShutdownBoth = SHUT_RDWR;
+    // a peer that went away must fail the send, not kill the process
+    constexpr int kSendFlags = MSG_NOSIGNAL;
+#endif
+
+    Socket::Socket(Handle handle)
+        : mHandle(handle)
+    {
+
+    }
+
+    Socket::Socket(Socket&& rhs) noexcept
+        : mHandle(std::exchange(rhs.mHandle, static_cast<Handle>(kInvalidSocket)))
+    {
+
+    }
+
+    Socket& Socket::operator=(Socket&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Close();
+            mHandle = std::exchange(rhs.mHandle, static_cast<Handle>(kInvalidSocket));
+        }
+        return *this;
+    }
+
+    Socket::~Socket()
+    {
+        Close();
+    }
+
+    void Socket::Close()
+    {
+        if (mHandle != static_cast<Handle>(kInvalidSocket))
+        {
+            _CloseSocket(mHandle);
+            mHandle = static_cast<Handle>(kInvalidSocket);
+        }
+    }
+
+    std::optional<Socket> Socket::Listen(uint16_t port)
+    {
+        _Startup();
+        Socket listener(static_cast<Handle>(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)));
+        if (listener.mHandle == static_cast<Handle>(kInvalidSocket))
+        {
+            return std::nullopt;
+        }
+
+        // a restarted coordinator can take its port back straight away
+        int reuse = 1;
+        setsockopt(listener.mHandle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (bind(listener.mHandle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener.mHandle, SOMAXCONN) != 0)
+        {
+            return std::nullopt;
+        }
+        return std::optional<Socket>(std::move(listener));
+    }
+
+    std::optional<Socket> Socket::Connect(const std::string& host, uint16_t port)
+    {
+        _Startup();
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<Socket> connected;
+        for (auto* address = addresses; address != nullptr && !connected.has_value(); address = address->ai_next)
+        {
+            Socket candidate(static_cast<Handle>(socket(address->ai_family, address->ai_socktype, address->ai_protocol)));
+            if (candidate.mHandle != static_cast<Handle>(kInvalidSocket) &&
+                connect(candidate.mHandle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0)
+            {
+                connected = std::move(candidate);
+            }
+        }
+        freeaddrinfo(addresses);
+
+        if (connected.has_value())
+        {
+            // messages are written whole, so there is nothing to gain from waiting to batch them
+            int noDelay = 1;
+            setsockopt(connected->mHandle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+        }
+        return connected;
+    }
+
+    std::optional<Socket> Socket::Accept(uint32_t timeoutMs)
+    {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(mHandle, &readable);
+        timeval timeout = {};
+        timeout.tv_sec = static_cast<long>(timeoutMs / 1000);
+        timeout.tv_usec = static_cast<long>((timeoutMs % 1000) * 1000);
+        if (select(static_cast<int>(mHandle + 1), &readable, nullptr, nullptr, &timeout) <= 0)
+        {
+            return std::nullopt;
+        }
+
+        Socket accepted(static_cast<Handle>(accept(mHandle, nullptr, nullptr)));
+        if (accepted.mHandle == static_cast<Handle>(kInvalidSocket))
+        {
+            return std::nullopt;
+        }
+        int noDelay = 1;
+        setsockopt(accepted.mHandle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+        return std::optional<Socket>(std::move(accepted));
+    }
+
+    bool Socket::SendAll(const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            const auto sent = send(mHandle, bytes, static_cast<int>(size), kSendFlags);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            bytes += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    bool Socket::ReceiveAll(void* data, size_t size)
+    {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0)
+        {
+            const auto received = recv(mHandle, bytes, static_cast<int>(size), 0);
+            if (received <= 0)
+            {
+                return false;
+            }
+            bytes += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    void Socket::Shutdown()
+    {
+        shutdown(mHandle, kShutdownBoth);
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef RTX_WEEKEND_SOCKET_H
+#define RTX_WEEKEND_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace hvk
+{
+    // A blocking TCP socket over Winsock or BSD sockets. Move only.
+    class Socket
+    {
+    public:
+        // listens on every interface
+        static std::optional<Socket> Listen(uint16_t port);
+        static std::optional<Socket> Connect(const std::string& host, uint16_t port);
+
+        Socket(Socket&& rhs) noexcept;
+        Socket& operator=(Socket&& rhs) noexcept;
+        Socket(const Socket&) = delete;
+        Socket& operator=(const Socket&) = delete;
+        ~Socket();
+
+        // Waits up to timeoutMs for a connection on a listening socket,
+        // returning nullopt if none arrived
+        std::optional<Socket> Accept(uint32_t timeoutMs);
+
+        // false once the connection is closed or broken
+        bool SendAll(const void* data, size_t size);
+        bool ReceiveAll(void* data, size_t size);
+
+        // Makes blocked and later sends and receives fail. Unlike closing,
+        // safe while another thread is using the socket.
+        void Shutdown();
+
+    private:
+#if defined(_WIN32)
+        using Handle = uintptr_t;
+#else
+        using Handle = int;
+#endif
+        explicit Socket(Handle handle);
+        void Close();
+
+        Handle mHandle;
+    };
+}
+
+#endif //RTX_WEEKEND_SOCKET_H
@@ -2,6 +2,8 @@
 #define RTX_WEEKEND_SPHERE_H
 
 #include "Vector.h"
+#include "AABB.h"
+#include "Float3.h"
 
 namespace hvk
 {
@@ -16,22 +18,17 @@ namespace hvk
             : Sphere({}, 0.f)
         {}
 
-        Vector getCenter() const { return mCenter; }
+        Vector getCenter() const { return mCenter.Load(); }
         float getRadius() const { return mRadius; }
-
-        Sphere& operator= (const Sphere& rhs)
+        AABB getBounds() const
         {
-            if (&rhs == this)
-            {
-                return *this;
-            }
-            mCenter = rhs.mCenter;
-            mRadius = rhs.mRadius;
-            return *this;
+            const Vector radius(mRadius, mRadius, mRadius);
+            const auto center = mCenter.Load();
+            return AABB(center - radius, center + radius);
         }
 
     private:
-        Vector mCenter;
+        Float3 mCenter;
         float mRadius;
     };
 }
@@ -6,6 +6,8 @@
 
 namespace hvk
 {
+    thread_local size_t _threadIndex = 0;
+
     WorkQueue::WorkQueue()
         : mMutex()
         , mQueue()
@@ -56,10 +58,12 @@ namespace hvk
     ThreadPool::ThreadPool(size_t numThreads)
     : mPool()
     , mQueue()
+    , mPending(0)
     {
         for (size_t i = 0; i < numThreads; ++i)
         {
-            mPool.emplace_back(std::thread([&]() {
+            mPool.emplace_back(std::thread([&, i]() {
+                _threadIndex = i + 1;
                 while (true)
                 {
                     auto job = mQueue.pop();
@@ -69,11 +73,30 @@ namespace hvk
                         break;
                     }
                     job();
+                    mPending.fetch_sub(1);
                 }
             }));
         }
     }
 
+    void ThreadPool::Wait()
+    {
+        while (mPending.load() > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    size_t ThreadPool::getNumThreads() const
+    {
+        return mPool.size();
+    }
+
+    size_t ThreadPool::getThreadIndex()
+    {
+        return _threadIndex;
+    }
+
     ThreadPool::~ThreadPool()
     {
         mQueue.push(nullptr);
@@ -6,6 +6,8 @@
 #include <functional>
 #include <queue>
 #include <mutex>
+#include <atomic>
+#include <algorithm>
 
 namespace hvk
 {
@@ -39,12 +41,36 @@ namespace hvk
         template<typename F, typename... Args>
         void QueueWork(F&& f, Args&&... args)
         {
+            mPending.fetch_add(1);
             mQueue.push([=]() { f(args...); });
         }
 
+        // Splits [0, count) into chunks of chunkSize and runs f(begin, end)
+        // for each of them on the pool, returning once all chunks are done
+        template<typename F>
+        void ParallelFor(size_t count, size_t chunkSize, F&& f)
+        {
+            for (size_t begin = 0; begin < count; begin += chunkSize)
+            {
+                const size_t end = std::min(count, begin + chunkSize);
+                QueueWork([&f, begin, end]() { f(begin, end); });
+            }
+            Wait();
+        }
+
+        // Blocks until all queued work, including work queued by other jobs,
+        // has finished. Must not be called from one of the pool's own threads.
+        void Wait();
+
+        size_t getNumThreads() const;
+
+        // 1 to getNumThreads on the pool's threads, 0 on any other thread
+        static size_t getThreadIndex();
+
     private:
         Pool mPool;
         WorkQueue mQueue;
+        std::atomic<size_t> mPending;
     };
 }
 
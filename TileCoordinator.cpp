@@ -0,0 +1,210 @@
+#include "TileCoordinator.h"
+
+#include <iostream>
+#include <thread>
+
+namespace hvk
+{
+    // how often Run checks whether the last result is in, or it was cancelled,
+    // while no one connects
+    constexpr uint32_t kAcceptTimeoutMs = 200;
+
+    bool _SendMessage(Socket& connection, MessageType type, const void* body = nullptr, size_t bodySize = 0)
+    {
+        const MessageHeader header = { kTileProtocolMagic, kTileProtocolVersion, type };
+        return connection.SendAll(&header, sizeof(header)) && (bodySize == 0 || connection.SendAll(body, bodySize));
+    }
+
+    bool _ReceiveHeader(Socket& connection, MessageType expected)
+    {
+        MessageHeader header = {};
+        return connection.ReceiveAll(&header, sizeof(header)) &&
+            header.magic == kTileProtocolMagic &&
+            header.version == kTileProtocolVersion &&
+            header.type == expected;
+    }
+
+    TileCoordinator::TileCoordinator(uint64_t sceneHash, std::vector<TileJob> jobs, ResultHandler onResult)
+        : mSceneHash(sceneHash)
+        , mJobs(std::move(jobs))
+        , mOnResult(std::move(onResult))
+        , mMutex()
+        , mChanged()
+        , mPending()
+        , mStatus(mJobs.size(), JobStatus{ JobState::Pending, 0, {} })
+        , mNumDone(0)
+        , mStopped(false)
+    {
+        for (uint32_t id = 0; id < mJobs.size(); ++id)
+        {
+            mJobs[id].id = id;
+            mPending.push_back(id);
+        }
+    }
+
+    bool TileCoordinator::Run(uint16_t port, const std::atomic<bool>& cancelRequested)
+    {
+        auto listener = Socket::Listen(port);
+        if (!listener.has_value())
+        {
+            return false;
+        }
+        std::cerr << "Serving " << mJobs.size() << " tiles on port " << port << std::endl;
+
+        std::vector<std::unique_ptr<Socket>> connections;
+        std::vector<std::thread> workers;
+        while (!cancelRequested)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                if (mNumDone == mJobs.size())
+                {
+                    break;
+                }
+            }
+
+            auto accepted = listener->Accept(kAcceptTimeoutMs);
+            if (accepted.has_value())
+            {
+                connections.push_back(std::make_unique<Socket>(std::move(accepted.value())));
+                Socket& connection = *connections.back();
+                const auto workerIndex = static_cast<uint32_t>(workers.size());
+                workers.emplace_back([this, &connection, workerIndex]() { ServeWorker(connection, workerIndex); });
+            }
+        }
+
+        // idle workers are told there is nothing left, busy and hung ones are cut off
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mStopped = true;
+            if (mNumDone < mJobs.size())
+            {
+                std::cerr << "Stopped serving with " << (mJobs.size() - mNumDone) << " tiles left" << std::endl;
+            }
+        }
+        mChanged.notify_all();
+        for (auto& connection : connections)
+        {
+            connection->Shutdown();
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        return true;
+    }
+
+    void TileCoordinator::ServeWorker(Socket& connection, uint32_t workerIndex)
+    {
+        HelloMessage hello = {};
+        if (!_ReceiveHeader(connection, MessageType::Hello) || !connection.ReceiveAll(&hello, sizeof(hello)))
+        {
+            return;
+        }
+        if (hello.sceneHash != mSceneHash)
+        {
+            std::cerr << "Refused worker " << workerIndex << ", it is rendering a different scene" << std::endl;
+            _SendMessage(connection, MessageType::Done);
+            return;
+        }
+        if (!_SendMessage(connection, MessageType::Welcome))
+        {
+            return;
+        }
+        std::cerr << "Worker " << workerIndex << " connected" << std::endl;
+
+        std::vector<TileSample> samples;
+        while (auto job = TakeJob())
+        {
+            TileJob result = {};
+            bool received = _SendMessage(connection, MessageType::Job, &job.value(), sizeof(TileJob)) &&
+                _ReceiveHeader(connection, MessageType::Result) &&
+                connection.ReceiveAll(&result, sizeof(result)) &&
+                result.id == job->id && result.width == job->width && result.height == job->height;
+            if (received)
+            {
+                samples.resize(result.width * result.height);
+                received = connection.ReceiveAll(samples.data(), samples.size() * sizeof(TileSample));
+            }
+            if (!received)
+            {
+                std::cerr << "Lost worker " << workerIndex << ", re-issuing tile " << job->id << std::endl;
+                Release(job->id);
+                return;
+            }
+            Complete(job.value(), samples);
+        }
+        _SendMessage(connection, MessageType::Done);
+    }
+
+    std::optional<TileJob> TileCoordinator::TakeJob()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (mNumDone < mJobs.size() && !mStopped)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            std::optional<uint32_t> id;
+            if (!mPending.empty())
+            {
+                id = mPending.front();
+                mPending.pop_front();
+            }
+            else
+            {
+                // hand out the most overdue job a second time
+                for (uint32_t candidate = 0; candidate < mStatus.size(); ++candidate)
+                {
+                    const auto& status = mStatus[candidate];
+                    if (status.state == JobState::Issued && now - status.issued > kJobTimeout &&
+                        (!id.has_value() || status.issued < mStatus[id.value()].issued))
+                    {
+                        id = candidate;
+                    }
+                }
+            }
+
+            if (id.has_value())
+            {
+                auto& status = mStatus[id.value()];
+                status.state = JobState::Issued;
+                status.issued = now;
+                ++status.numHolders;
+                return mJobs[id.value()];
+            }
+            // woken by a released or completed job, or in time to find one overdue
+            mChanged.wait_for(lock, std::chrono::seconds(1));
+        }
+        return std::nullopt;
+    }
+
+    void TileCoordinator::Release(uint32_t jobId)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        auto& status = mStatus[jobId];
+        --status.numHolders;
+        if (status.state == JobState::Issued && status.numHolders == 0)
+        {
+            status.state = JobState::Pending;
+            mPending.push_front(jobId);
+            mChanged.notify_one();
+        }
+    }
+
+    void TileCoordinator::Complete(const TileJob& job, const std::vector<TileSample>& samples)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        auto& status = mStatus[job.id];
+        --status.numHolders;
+        if (status.state == JobState::Done)
+        {
+            return;
+        }
+        status.state = JobState::Done;
+        mOnResult(job, samples);
+        ++mNumDone;
+        if (mNumDone == mJobs.size())
+        {
+            mChanged.notify_all();
+        }
+    }
+}
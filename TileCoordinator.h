@@ -0,0 +1,78 @@
+#ifndef RTX_WEEKEND_TILECOORDINATOR_H
+#define RTX_WEEKEND_TILECOORDINATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "Socket.h"
+#include "TileProtocol.h"
+
+namespace hvk
+{
+    // Hands tile jobs out to worker processes over TCP and collects their
+    // results. A job whose worker disconnects goes back in the queue, and one
+    // that has been out for longer than kJobTimeout is handed to the next idle
+    // worker as well, so a hung worker delays the image rather than stalls it.
+    // The first result in for a job wins.
+    class TileCoordinator
+    {
+    public:
+        using ResultHandler = std::function<void(const TileJob& job, const std::vector<TileSample>& samples)>;
+
+        static constexpr std::chrono::seconds kJobTimeout = std::chrono::seconds(60);
+
+        // onResult is called once per job, one call at a time
+        TileCoordinator(uint64_t sceneHash, std::vector<TileJob> jobs, ResultHandler onResult);
+
+        // Serves workers connecting to port until every job has a result or
+        // cancelRequested is set, when the jobs still out are abandoned.
+        // Returns false if the port cannot be listened on.
+        bool Run(uint16_t port, const std::atomic<bool>& cancelRequested);
+
+    private:
+        enum class JobState
+        {
+            Pending,
+            Issued,
+            Done
+        };
+
+        struct JobStatus
+        {
+            JobState state;
+            // workers the job is out with, more than one once re-issued
+            uint32_t numHolders;
+            std::chrono::steady_clock::time_point issued;
+        };
+
+        void ServeWorker(Socket& connection, uint32_t workerIndex);
+        // Blocks until a job is pending or overdue, or until every job is done
+        // or Run stops, in which case it returns nullopt
+        std::optional<TileJob> TakeJob();
+        // the worker holding the job is gone
+        void Release(uint32_t jobId);
+        void Complete(const TileJob& job, const std::vector<TileSample>& samples);
+
+        uint64_t mSceneHash;
+        std::vector<TileJob> mJobs;
+        ResultHandler mOnResult;
+
+        std::mutex mMutex;
+        std::condition_variable mChanged;
+        std::deque<uint32_t> mPending;
+        std::vector<JobStatus> mStatus;
+        size_t mNumDone;
+        // set once Run stops serving, done or not
+        bool mStopped;
+    };
+}
+
+#endif //RTX_WEEKEND_TILECOORDINATOR_H
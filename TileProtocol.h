@@ -0,0 +1,67 @@
+#ifndef RTX_WEEKEND_TILEPROTOCOL_H
+#define RTX_WEEKEND_TILEPROTOCOL_H
+
+#include <cstdint>
+
+#include "Float3.h"
+
+namespace hvk
+{
+    // Messages between the tile coordinator and its workers. Each is a
+    // MessageHeader followed by the struct its type names, sent as raw bytes,
+    // so both ends must share an architecture; in practice they are the same
+    // build. After the hello and welcome the worker loops on receiving a job
+    // and sending back its result until it receives done.
+    constexpr uint32_t kTileProtocolMagic = 0x54585452; // "RTXT"
+    constexpr uint32_t kTileProtocolVersion = 1;
+
+    enum class MessageType : uint32_t
+    {
+        // worker to coordinator on connecting, followed by HelloMessage
+        Hello,
+        // coordinator to worker, accepting it, with nothing after
+        Welcome,
+        // coordinator to worker, followed by TileJob
+        Job,
+        // worker to coordinator, followed by the TileJob and then one
+        // TileSample per pixel of the tile, row by row
+        Result,
+        // coordinator to worker: no more jobs, or the worker was refused
+        Done
+    };
+
+    struct MessageHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        MessageType type;
+    };
+
+    struct HelloMessage
+    {
+        // Scene::getHash mixed with the image and camera, see main
+        uint64_t sceneHash;
+    };
+
+    // A tile to add sampleCount samples per pixel to. x and y count pixels
+    // from the top left of the image.
+    struct TileJob
+    {
+        uint32_t id;
+        uint16_t x;
+        uint16_t y;
+        uint16_t width;
+        uint16_t height;
+        uint32_t sampleCount;
+    };
+
+    struct TileSample
+    {
+        Float3 sum;
+        uint32_t count;
+    };
+
+    static_assert(sizeof(TileSample) == 16);
+}
+
+#endif //RTX_WEEKEND_TILEPROTOCOL_H
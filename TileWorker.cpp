@@ -0,0 +1,79 @@
+#include "TileWorker.h"
+
+#include <utility>
+
+#include "Socket.h"
+
+namespace hvk
+{
+    TileWorker::TileWorker(uint64_t sceneHash, TileRenderer renderTile)
+        : mSceneHash(sceneHash)
+        , mRenderTile(std::move(renderTile))
+        , mNumTilesRendered(0)
+    {
+
+    }
+
+    bool TileWorker::Run(const std::string& host, uint16_t port, const std::atomic<bool>& cancelRequested)
+    {
+        auto connection = Socket::Connect(host, port);
+        if (!connection.has_value())
+        {
+            return false;
+        }
+
+        const MessageHeader hello = { kTileProtocolMagic, kTileProtocolVersion, MessageType::Hello };
+        const HelloMessage helloBody = { mSceneHash };
+        MessageHeader reply = {};
+        if (!connection->SendAll(&hello, sizeof(hello)) ||
+            !connection->SendAll(&helloBody, sizeof(helloBody)) ||
+            !connection->ReceiveAll(&reply, sizeof(reply)) ||
+            reply.magic != kTileProtocolMagic ||
+            reply.version != kTileProtocolVersion ||
+            reply.type != MessageType::Welcome)
+        {
+            return false;
+        }
+
+        const MessageHeader resultHeader = { kTileProtocolMagic, kTileProtocolVersion, MessageType::Result };
+        std::vector<TileSample> samples;
+        while (true)
+        {
+            MessageHeader header = {};
+            if (!connection->ReceiveAll(&header, sizeof(header)) || header.magic != kTileProtocolMagic)
+            {
+                return false;
+            }
+            if (header.type == MessageType::Done)
+            {
+                return true;
+            }
+
+            TileJob job = {};
+            if (header.type != MessageType::Job || !connection->ReceiveAll(&job, sizeof(job)))
+            {
+                return false;
+            }
+
+            samples.assign(job.width * job.height, TileSample{});
+            mRenderTile(job, samples);
+            // the tile may be unfinished, returning closes the connection
+            if (cancelRequested)
+            {
+                return false;
+            }
+            if (!connection->SendAll(&resultHeader, sizeof(resultHeader)) ||
+                !connection->SendAll(&job, sizeof(job)) ||
+                !connection->SendAll(samples.data(), samples.size() * sizeof(TileSample)))
+            {
+                return false;
+            }
+            ++mNumTilesRendered;
+        }
+    }
+
+    uint32_t TileWorker::getNumTilesRendered() const
+    {
+        return mNumTilesRendered;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef RTX_WEEKEND_TILEWORKER_H
+#define RTX_WEEKEND_TILEWORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "TileProtocol.h"
+
+namespace hvk
+{
+    // The other end of a TileCoordinator: pulls tile jobs, renders each with
+    // the renderer it was given and sends back the samples.
+    class TileWorker
+    {
+    public:
+        // fills samples with the job's tile, row by row
+        using TileRenderer = std::function<void(const TileJob& job, std::vector<TileSample>& samples)>;
+
+        TileWorker(uint64_t sceneHash, TileRenderer renderTile);
+
+        // Renders jobs from the coordinator at host:port until it has none
+        // left. Once cancelRequested is set it hangs up instead of sending its
+        // tile, which the coordinator then hands to another worker. Returns
+        // false if it was cancelled, or if the coordinator could not be
+        // reached, refused this worker or went away part way.
+        bool Run(const std::string& host, uint16_t port, const std::atomic<bool>& cancelRequested);
+
+        uint32_t getNumTilesRendered() const;
+
+    private:
+        uint64_t mSceneHash;
+        TileRenderer mRenderTile;
+        uint32_t mNumTilesRendered;
+    };
+}
+
+#endif //RTX_WEEKEND_TILEWORKER_H
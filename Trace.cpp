@@ -0,0 +1,107 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace hvk
+{
+    namespace trace
+    {
+        // a deque, so each thread's events stay put as other threads register
+        std::mutex _registryMutex;
+        std::deque<std::vector<Event>> _registry;
+        // timestamps are written relative to the first use of the trace
+        const Clock::time_point _epoch = Clock::now();
+
+        std::vector<Event>& _LocalEvents()
+        {
+            thread_local std::vector<Event>& events = []() -> std::vector<Event>&
+            {
+                std::unique_lock<std::mutex> lock(_registryMutex);
+                return _registry.emplace_back();
+            }();
+            return events;
+        }
+
+        double _Microseconds(Clock::time_point time)
+        {
+            return std::chrono::duration<double, std::micro>(time - _epoch).count();
+        }
+
+        void Record(const Event& event)
+        {
+            _LocalEvents().push_back(event);
+        }
+
+        bool Write(const std::string& path)
+        {
+            std::unique_lock<std::mutex> lock(_registryMutex);
+
+            std::ofstream file(path, std::ios::trunc);
+            file << std::fixed << std::setprecision(3);
+            file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+            // name the rows, pool threads count from 1
+            uint32_t maxThread = 0;
+            for (const auto& events : _registry)
+            {
+                for (const auto& event : events)
+                {
+                    maxThread = std::max(maxThread, event.thread);
+                }
+            }
+            for (uint32_t thread = 0; thread <= maxThread; ++thread)
+            {
+                file << (thread == 0 ? "" : ",\n")
+                     << "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 0, \"tid\": " << thread
+                     << ", \"args\": {\"name\": \"";
+                if (thread == 0)
+                {
+                    file << "main";
+                }
+                else
+                {
+                    file << "worker " << thread;
+                }
+                file << "\"}}";
+            }
+
+            for (const auto& events : _registry)
+            {
+                for (const auto& event : events)
+                {
+                    file << ",\n{\"ph\": \"X\", \"name\": \"" << event.name << "\", \"pid\": 0, \"tid\": " << event.thread
+                         << ", \"ts\": " << _Microseconds(event.begin)
+                         << ", \"dur\": " << std::chrono::duration<double, std::micro>(event.end - event.begin).count();
+                    if (event.x >= 0)
+                    {
+                        file << ", \"args\": {\"x\": " << event.x << ", \"y\": " << event.y << "}";
+                    }
+                    file << "}";
+                }
+            }
+            file << "\n]}\n";
+            return static_cast<bool>(file);
+        }
+
+        Scope::Scope(const char* name, int32_t x, int32_t y)
+            : mName(name)
+            , mX(x)
+            , mY(y)
+            , mBegin(Clock::now())
+        {
+
+        }
+
+        Scope::~Scope()
+        {
+            Record({ mName, mBegin, Clock::now(), static_cast<uint32_t>(ThreadPool::getThreadIndex()), mX, mY });
+        }
+    }
+}
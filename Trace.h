@@ -0,0 +1,73 @@
+#ifndef RTX_WEEKEND_TRACE_H
+#define RTX_WEEKEND_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace hvk
+{
+    namespace trace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // One span of work on one thread. name must outlive the trace, which
+        // string literals do.
+        struct Event
+        {
+            const char* name;
+            Clock::time_point begin;
+            Clock::time_point end;
+            // ThreadPool::getThreadIndex of the thread that did the work
+            uint32_t thread;
+            // pixel the work starts at, for tiles, or -1
+            int32_t x;
+            int32_t y;
+        };
+
+        // Adds event to this thread's events, which no other thread touches,
+        // so recording takes no lock after a thread's first event.
+        void Record(const Event& event);
+
+        // Writes every recorded event as Chrome trace event JSON, which
+        // chrome://tracing and Perfetto open, one row per pool thread. Only
+        // exact while no thread is recording.
+        bool Write(const std::string& path);
+
+        // Records the time from its construction to its destruction
+        class Scope
+        {
+        public:
+            explicit Scope(const char* name, int32_t x = -1, int32_t y = -1);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            const char* mName;
+            int32_t mX;
+            int32_t mY;
+            Clock::time_point mBegin;
+        };
+
+        // tracing is compiled out unless the build asks for it, see CMakeLists.txt
+#if defined(RTX_WEEKEND_TRACE)
+        constexpr bool kEnabled = true;
+#else
+        constexpr bool kEnabled = false;
+#endif
+    }
+}
+
+#define RTX_WEEKEND_TRACE_CONCAT_INNER(a, b) a##b
+#define RTX_WEEKEND_TRACE_CONCAT(a, b) RTX_WEEKEND_TRACE_CONCAT_INNER(a, b)
+
+// RTX_WEEKEND_TRACE_SCOPE(name) or RTX_WEEKEND_TRACE_SCOPE(name, x, y) times the rest of the enclosing block
+#if defined(RTX_WEEKEND_TRACE)
+#define RTX_WEEKEND_TRACE_SCOPE(...) ::hvk::trace::Scope RTX_WEEKEND_TRACE_CONCAT(_traceScope, __LINE__)(__VA_ARGS__)
+#else
+#define RTX_WEEKEND_TRACE_SCOPE(...) ((void)0)
+#endif
+
+#endif //RTX_WEEKEND_TRACE_H
@@ -0,0 +1,95 @@
+#include "Transform.h"
+
+#include <cmath>
+
+namespace hvk
+{
+    Transform::Transform()
+        : mRotation({Vector(1.f, 0.f, 0.f), Vector(0.f, 1.f, 0.f), Vector(0.f, 0.f, 1.f)})
+        , mTranslation()
+        , mScale(1.f)
+        , mIsIdentity(true)
+    {
+    }
+
+    Transform::Transform(const Vector& translation, const Vector& eulerRadians, float scale)
+        : mRotation()
+        , mTranslation(translation)
+        , mScale(scale)
+        , mIsIdentity(false)
+    {
+        // R = Rz * Ry * Rx
+        const float cx = cos(eulerRadians.X());
+        const float sx = sin(eulerRadians.X());
+        const float cy = cos(eulerRadians.Y());
+        const float sy = sin(eulerRadians.Y());
+        const float cz = cos(eulerRadians.Z());
+        const float sz = sin(eulerRadians.Z());
+
+        mRotation[0] = Vector(cz * cy, cz * sy * sx - sz * cx, cz * sy * cx + sz * sx);
+        mRotation[1] = Vector(sz * cy, sz * sy * sx + cz * cx, sz * sy * cx - cz * sx);
+        mRotation[2] = Vector(-sy, cy * sx, cy * cx);
+    }
+
+    Vector Transform::TransformDirection(const Vector& d) const
+    {
+        return Vector(
+            Vector::Dot(mRotation[0], d),
+            Vector::Dot(mRotation[1], d),
+            Vector::Dot(mRotation[2], d));
+    }
+
+    Vector Transform::TransformPoint(const Vector& p) const
+    {
+        if (mIsIdentity)
+        {
+            return p;
+        }
+        return TransformDirection(p * mScale) + mTranslation;
+    }
+
+    Vector Transform::InverseTransformDirection(const Vector& d) const
+    {
+        // the rotation is orthonormal, so its inverse is its transpose
+        return (d.X() * mRotation[0]) + (d.Y() * mRotation[1]) + (d.Z() * mRotation[2]);
+    }
+
+    Vector Transform::InverseTransformPoint(const Vector& p) const
+    {
+        if (mIsIdentity)
+        {
+            return p;
+        }
+        return InverseTransformDirection(p - mTranslation) / mScale;
+    }
+
+    AABB Transform::TransformBounds(const AABB& bounds) const
+    {
+        if (mIsIdentity || bounds.IsEmpty())
+        {
+            return bounds;
+        }
+
+        const auto min = bounds.getMin();
+        const auto max = bounds.getMax();
+        AABB transformed;
+        for (size_t corner = 0; corner < 8; ++corner)
+        {
+            transformed.Grow(TransformPoint(Vector(
+                (corner & 1) ? max.X() : min.X(),
+                (corner & 2) ? max.Y() : min.Y(),
+                (corner & 4) ? max.Z() : min.Z())));
+        }
+        return transformed;
+    }
+
+    float Transform::getScale() const
+    {
+        return mScale;
+    }
+
+    bool Transform::IsIdentity() const
+    {
+        return mIsIdentity;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef RTX_WEEKEND_TRANSFORM_H
+#define RTX_WEEKEND_TRANSFORM_H
+
+#include <array>
+
+#include "Vector.h"
+#include "AABB.h"
+
+namespace hvk
+{
+    // Rigid transform with uniform scale. Keeping the scale uniform means
+    // spheres stay spheres and normals only need to be rotated.
+    class Transform
+    {
+    public:
+        Transform();
+        Transform(const Vector& translation, const Vector& eulerRadians, float scale);
+
+        Vector TransformPoint(const Vector& p) const;
+        Vector TransformDirection(const Vector& d) const;
+        Vector InverseTransformPoint(const Vector& p) const;
+        Vector InverseTransformDirection(const Vector& d) const;
+
+        AABB TransformBounds(const AABB& bounds) const;
+
+        float getScale() const;
+        bool IsIdentity() const;
+
+    private:
+        // rows of the rotation matrix
+        std::array<Vector, 3> mRotation;
+        Vector mTranslation;
+        float mScale;
+        bool mIsIdentity;
+    };
+}
+
+#endif //RTX_WEEKEND_TRANSFORM_H
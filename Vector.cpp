@@ -35,6 +35,21 @@ namespace hvk
         return XMVectorGetZ(mNativeVec);
     }
 
+    float Vector::GetComponent(size_t index) const
+    {
+        return XMVectorGetByIndex(mNativeVec, index);
+    }
+
+    Vector Vector::Min(const Vector& lhs, const Vector& rhs)
+    {
+        return Vector(XMVectorMin(lhs.mNativeVec, rhs.mNativeVec));
+    }
+
+    Vector Vector::Max(const Vector& lhs, const Vector& rhs)
+    {
+        return Vector(XMVectorMax(lhs.mNativeVec, rhs.mNativeVec));
+    }
+
     float Vector::Dot(const Vector& rhs) const
     {
         return XMVectorGetX(XMVector3Dot(mNativeVec, rhs.mNativeVec));
@@ -82,16 +97,6 @@ namespace hvk
 
     }
 
-    Vector& Vector::operator= (const Vector& rhs)
-    {
-        if (&rhs == this)
-        {
-            return *this;
-        }
-        mNativeVec = rhs.mNativeVec;
-        return *this;
-    }
-
     Vector& Vector::operator+= (const Vector& rhs)
     {
         mNativeVec += rhs.mNativeVec;
@@ -110,10 +115,13 @@ namespace hvk
 
     Vector Vector::RandomUnit()
     {
-        auto azimuth = math::getRandom<double, 0.f, 2 * XM_PI>();
-        auto polar = math::getRandom<double, 0.f, 2 * XM_PI>();
+        auto azimuth = math::getRandom<Real, Real(0), Real(2 * XM_PI)>();
+        auto polar = math::getRandom<Real, Real(0), Real(2 * XM_PI)>();
         auto radial = 1.f;
-        return Vector(sin(polar) * cos(azimuth), sin(polar) * sin(azimuth), cos(polar));
+        return Vector(
+            static_cast<float>(std::sin(polar) * std::cos(azimuth)),
+            static_cast<float>(std::sin(polar) * std::sin(azimuth)),
+            static_cast<float>(std::cos(polar)));
     }
 
     Vector Vector::Reflect(const Vector &v, const Vector &normal)
@@ -121,7 +129,7 @@ namespace hvk
         return v - 2 * Vector::Dot(v, normal) * normal;
     }
 
-    double _SchlickFresnelApproximation(double cosineTheta, double refraction)
+    Real _SchlickFresnelApproximation(Real cosineTheta, Real refraction)
     {
         // Schlick Approximation formula:
         //  F = F0 + (1 - F0) * (1 - cos(theta))^5
@@ -130,21 +138,21 @@ namespace hvk
 
         auto f0 = (1 - refraction) / (1 + refraction);
         f0 = f0 * f0;
-        return f0 + (1 - f0) * pow((1 - cosineTheta), 5);
+        return f0 + (1 - f0) * std::pow((1 - cosineTheta), 5);
     }
 
-    Vector Vector::Refract(const Vector &incident, const Vector &normal, double iorLeave, double iorEnter)
+    Vector Vector::Refract(const Vector &incident, const Vector &normal, Real iorLeave, Real iorEnter)
     {
-        auto IN = Vector::Dot(incident.Normalized(), normal.Normalized());
+        Real IN = Vector::Dot(incident.Normalized(), normal.Normalized());
         if (IN > 0.f)
         {
-            double temp = iorLeave;
+            Real temp = iorLeave;
             iorLeave = iorEnter;
             iorEnter = temp;
         }
         // assert(IN >= 0.f);
-        double eta = iorLeave / iorEnter;
-        double k = 1 - (eta * eta) * (1 - (IN * IN));
+        Real eta = iorLeave / iorEnter;
+        Real k = 1 - (eta * eta) * (1 - (IN * IN));
         if (k < 0)
         {
             // total internal reflection
@@ -152,12 +160,12 @@ namespace hvk
         }
         else
         {
-            double reflectProbability = _SchlickFresnelApproximation(abs(IN), iorLeave / iorEnter);
-            if (math::getRandom<double, 0.f, 1.f>() < reflectProbability)
+            Real reflectProbability = _SchlickFresnelApproximation(std::abs(IN), iorLeave / iorEnter);
+            if (math::getRandom<Real, Real(0), Real(1)>() < reflectProbability)
             {
                 return Reflect(incident, normal);
             }
-            return eta * incident + (eta * IN - sqrt(k)) * normal;
+            return static_cast<float>(eta) * incident + static_cast<float>(eta * IN - std::sqrt(k)) * normal;
         }
     }
 }
@@ -10,6 +10,8 @@ using namespace DirectX;
 
 #include <utility>
 
+#include "Real.h"
+
 #if defined(WIN32)
 using SIMDVEC = XMVECTOR;
 #endif
@@ -24,12 +26,8 @@ namespace hvk
         explicit Vector(const SIMDVEC& sv)
             : mNativeVec(sv)
         {}
-        Vector(const Vector& v)
-            : mNativeVec(v.mNativeVec)
-        {}
-        Vector(Vector&& v)
-            : mNativeVec(std::move(v.mNativeVec))
-        {}
+        Vector(const Vector& v) = default;
+        Vector(Vector&& v) = default;
 
         Vector Normalized() const;
 
@@ -39,6 +37,7 @@ namespace hvk
         float X() const;
         float Y() const;
         float Z() const;
+        float GetComponent(size_t index) const;
 
         float Dot(const Vector& rhs) const;
         Vector Cross(const Vector& rhs) const;
@@ -48,12 +47,15 @@ namespace hvk
         static Vector Refract(
                 const Vector& incident,
                 const Vector& normal,
-                double iorLeave,
-                double iorEnter);
+                Real iorLeave,
+                Real iorEnter);
+
+        static Vector Min(const Vector& lhs, const Vector& rhs);
+        static Vector Max(const Vector& lhs, const Vector& rhs);
 
         static Vector RandomUnit();
 
-        Vector& operator= (const Vector& rhs);
+        Vector& operator= (const Vector& rhs) = default;
         Vector& operator+= (const Vector& rhs);
         Vector operator+ (const Vector& rhs) const;
         Vector operator- (const Vector& rhs) const;
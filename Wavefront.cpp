@@ -0,0 +1,127 @@
+#include "Wavefront.h"
+#include "Morton.h"
+#include "RayStats.h"
+#include "PathStats.h"
+
+#include <algorithm>
+
+namespace hvk
+{
+    WavefrontIntegrator::WavefrontIntegrator(const Scene& scene, bool reorderRays) :
+        mScene(scene),
+        mReorderRays(reorderRays),
+        mSceneBounds(scene.getBounds()),
+        mPaths(),
+        mNextPaths(),
+        mSortKeys()
+    {
+
+    }
+
+    void WavefrontIntegrator::Trace(const std::vector<Ray>& primaryRays, std::vector<Color>& outColors)
+    {
+        outColors.assign(primaryRays.size(), Color(0.f, 0.f, 0.f));
+
+        mPaths.clear();
+        mPaths.reserve(primaryRays.size());
+        for (size_t i = 0; i < primaryRays.size(); ++i)
+        {
+            mPaths.push_back(Path{primaryRays[i], Color(1.f, 1.f, 1.f), static_cast<uint32_t>(i), static_cast<uint8_t>(kNoMaterial)});
+        }
+
+        // paths still alive after the last bounce stay black, as in rayColor
+        for (int depth = kMaxRayDepth; depth > 0 && !mPaths.empty(); --depth)
+        {
+            if (mReorderRays && depth < kMaxRayDepth)
+            {
+                SortPaths();
+            }
+
+            mNextPaths.clear();
+            if (depth == kMaxRayDepth)
+            {
+                RTX_WEEKEND_COUNT(cameraRays, mPaths.size());
+            }
+            else
+            {
+                RTX_WEEKEND_COUNT(bounceRays, mPaths.size());
+            }
+            for (const auto& path : mPaths)
+            {
+                const auto sceneHit = mScene.Intersect(path.ray);
+                if (!sceneHit.has_value())
+                {
+                    RTX_WEEKEND_COUNT_PATH(PathEnd::Sky, path.lastMaterial, kMaxRayDepth - depth);
+                    outColors[path.index] = path.throughput * SkyColor(path.ray);
+                    continue;
+                }
+
+                const auto materialType = static_cast<uint8_t>(sceneHit->material->getType());
+                Ray scattered = Ray(Vector(), Vector());
+                Color attenuation(0.f, 0.f, 0.f);
+                if (Scatter(path.ray, *sceneHit->material, sceneHit->record, attenuation, scattered))
+                {
+                    mNextPaths.push_back(Path{scattered, path.throughput * attenuation, path.index, materialType});
+                }
+                else
+                {
+                    RTX_WEEKEND_COUNT_PATH(
+                        sceneHit->material->getType() == MaterialType::Metal ? PathEnd::FailedReflection : PathEnd::Absorbed,
+                        materialType,
+                        kMaxRayDepth - depth);
+                    outColors[path.index] = path.throughput * attenuation;
+                }
+            }
+            std::swap(mPaths, mNextPaths);
+        }
+
+        for (const auto& path : mPaths)
+        {
+            RTX_WEEKEND_COUNT_PATH(PathEnd::DepthLimit, path.lastMaterial, kMaxRayDepth);
+        }
+    }
+
+    uint64_t WavefrontIntegrator::GetSortKey(const Ray& ray) const
+    {
+        const auto direction = ray.getDirection();
+        const uint64_t octant =
+            (direction.X() < 0.f ? 4u : 0u) | (direction.Y() < 0.f ? 2u : 0u) | (direction.Z() < 0.f ? 1u : 0u);
+
+        // flat axes map to 0, origins outside the bounds (plane hits) clamp to the edge
+        const auto extent = mSceneBounds.Extent();
+        const auto relative = ray.getOrigin() - mSceneBounds.getMin();
+        const auto normalize = [](float offset, float size) {
+            return size > 0.f ? offset / size : 0.f;
+        };
+        const uint64_t code = morton::Encode30(
+            normalize(relative.X(), extent.X()),
+            normalize(relative.Y(), extent.Y()),
+            normalize(relative.Z(), extent.Z()));
+
+        return (octant << 30) | code;
+    }
+
+    void WavefrontIntegrator::SortPaths()
+    {
+        if (mSceneBounds.IsEmpty())
+        {
+            return;
+        }
+
+        mSortKeys.clear();
+        mSortKeys.reserve(mPaths.size());
+        for (uint32_t i = 0; i < mPaths.size(); ++i)
+        {
+            mSortKeys.emplace_back(GetSortKey(mPaths[i].ray), i);
+        }
+        std::sort(mSortKeys.begin(), mSortKeys.end());
+
+        mNextPaths.clear();
+        mNextPaths.reserve(mPaths.size());
+        for (const auto& [key, i] : mSortKeys)
+        {
+            mNextPaths.push_back(mPaths[i]);
+        }
+        std::swap(mPaths, mNextPaths);
+    }
+}
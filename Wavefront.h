@@ -0,0 +1,51 @@
+#ifndef RTX_WEEKEND_WAVEFRONT_H
+#define RTX_WEEKEND_WAVEFRONT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Ray.h"
+#include "Vector.h"
+#include "AABB.h"
+#include "Scene.h"
+#include "Integrator.h"
+
+namespace hvk
+{
+    // Traces a batch of paths breadth first: one bounce of every live path is
+    // traced before any path takes its next. Past the primary rays, which are
+    // coherent already, the live rays can be sorted each bounce so that rays
+    // leaving nearby points in similar directions are traced back to back and
+    // find the BVH nodes they need still in cache.
+    class WavefrontIntegrator
+    {
+    public:
+        WavefrontIntegrator(const Scene& scene, bool reorderRays);
+
+        // outColors[i] receives the color of the path started by primaryRays[i]
+        void Trace(const std::vector<Ray>& primaryRays, std::vector<Color>& outColors);
+
+    private:
+        struct Path
+        {
+            Ray ray;
+            Color throughput;
+            uint32_t index;
+            // type of the surface the path last scattered off, see PathStats.h
+            uint8_t lastMaterial;
+        };
+
+        // direction octant above the Morton code of the origin in the scene bounds
+        uint64_t GetSortKey(const Ray& ray) const;
+        void SortPaths();
+
+        const Scene& mScene;
+        bool mReorderRays;
+        AABB mSceneBounds;
+        std::vector<Path> mPaths;
+        std::vector<Path> mNextPaths;
+        std::vector<std::pair<uint64_t, uint32_t>> mSortKeys;
+    };
+}
+
+#endif //RTX_WEEKEND_WAVEFRONT_H
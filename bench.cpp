@@ -0,0 +1,315 @@
+// rtx_bench renders each canonical scene (see Scenes.h) at a fixed size,
+// sample count and seed, and prints what each took as JSON, along with how
+// far each image is from a reference rendered with many more samples (see
+// ImageMetrics.h). After rendering it animates the spheres of each scene for a
+// few frames, timing Scene::Update, and checks every refit traces like a
+// fresh build, failing if one doesn't. Rays per second and tests per ray
+// need the counters, configure with -DRTX_WEEKEND_RAY_STATS=ON for them.
+//
+//  rtx_bench [--samples N] [--threads N] [--scene NAME] [--references DIR] > results.json
+//  rtx_bench --write-references DIR [--samples N] [--scene NAME]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "Camera.h"
+#include "Float3.h"
+#include "Image.h"
+#include "ImageMetrics.h"
+#include "Integrator.h"
+#include "RayStats.h"
+#include "Scene.h"
+#include "Scenes.h"
+#include "Sphere.h"
+#include "ThreadPool.h"
+#include "math.h"
+
+const uint16_t kImageWidth = 320;
+const uint16_t kImageHeight = 180;
+const uint16_t kBenchSamples = 16;
+const uint16_t kReferenceSamples = 1024;
+const uint32_t kSeed = 1;
+const hvk::BVHBuildQuality kBuildQuality = hvk::BVHBuildQuality::High;
+const uint16_t kUpdateFrames = 8;
+// camera rays traced against both the updated and a fresh scene, per axis
+const uint16_t kCheckRaysX = 64;
+const uint16_t kCheckRaysY = 36;
+
+struct BenchOptions
+{
+    uint16_t numSamples;
+    size_t numThreads;
+    // only this one of the canonical scenes, if given
+    std::optional<std::string> sceneName;
+    // where the references are read from, or written to when writeReferences
+    std::optional<std::string> referencePath;
+    bool writeReferences;
+};
+
+std::optional<BenchOptions> parseOptions(int argc, char** argv)
+{
+    BenchOptions options = { 0, std::max(1u, std::thread::hardware_concurrency()), std::nullopt, std::nullopt, false };
+    std::optional<uint16_t> numSamples;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr)
+        {
+            return std::nullopt;
+        }
+        ++i;
+
+        char* end = nullptr;
+        const unsigned long number = std::strtoul(value, &end, 10);
+        const bool isNumber = end != value && *end == '\0' && value[0] != '-' && number > 0;
+        if (std::strcmp(argument, "--samples") == 0 && isNumber && number <= UINT16_MAX)
+        {
+            numSamples = static_cast<uint16_t>(number);
+        }
+        else if (std::strcmp(argument, "--threads") == 0 && isNumber && number <= 1024)
+        {
+            options.numThreads = number;
+        }
+        else if (std::strcmp(argument, "--scene") == 0)
+        {
+            options.sceneName = std::string(value);
+        }
+        else if (std::strcmp(argument, "--references") == 0)
+        {
+            options.referencePath = std::string(value);
+        }
+        else if (std::strcmp(argument, "--write-references") == 0)
+        {
+            options.referencePath = std::string(value);
+            options.writeReferences = true;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+    options.numSamples = numSamples.value_or(options.writeReferences ? kReferenceSamples : kBenchSamples);
+    return options;
+}
+
+// One task per scanline, rows top down like the images rtx_weekend writes.
+// Each row draws from its own stream, so that the image is the same bit for
+// bit whichever threads render it.
+std::vector<hvk::Float3> renderImage(const hvk::Scene& scene, const hvk::Camera& camera, uint16_t numSamples, hvk::ThreadPool& pool)
+{
+    std::vector<hvk::Float3> colors(kImageWidth * kImageHeight);
+    pool.ParallelFor(kImageHeight, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t row = begin; row < end; ++row)
+        {
+            hvk::math::seedThread(kSeed, static_cast<uint32_t>(row));
+            const int i = (kImageHeight - 1) - static_cast<int>(row);
+            for (int j = 0; j < kImageWidth; ++j)
+            {
+                const auto sum = hvk::SamplePixel(scene, camera, i, j, kImageWidth, kImageHeight, numSamples);
+                const auto color = sum / static_cast<float>(numSamples);
+                colors[row * kImageWidth + j] = hvk::Float3(color);
+            }
+        }
+    });
+    return colors;
+}
+
+// bobs every sphere up and down by a fraction of its radius, so that the
+// scene keeps its shape and refits stay cheap
+void moveSpheres(entt::registry& registry, uint16_t frame)
+{
+    size_t index = 0;
+    registry.view<hvk::Sphere>().each([&](auto entity, const hvk::Sphere& sphere)
+    {
+        const float offset = 0.1f * sphere.getRadius() * std::sin(0.5f * frame + static_cast<float>(index++));
+        registry.replace<hvk::Sphere>(entity, sphere.getCenter() + hvk::Vector(0.f, offset, 0.f), sphere.getRadius());
+    });
+}
+
+// camera rays that hit something different in the two scenes
+size_t countMismatches(const hvk::Scene& updated, const hvk::Scene& fresh, const hvk::Camera& camera)
+{
+    size_t mismatches = 0;
+    for (uint16_t y = 0; y < kCheckRaysY; ++y)
+    {
+        for (uint16_t x = 0; x < kCheckRaysX; ++x)
+        {
+            const hvk::Ray ray = camera.GetRay(
+                (x + static_cast<hvk::Real>(0.5)) / kCheckRaysX,
+                (y + static_cast<hvk::Real>(0.5)) / kCheckRaysY);
+            const auto a = updated.Intersect(ray);
+            const auto b = fresh.Intersect(ray);
+            if (a.has_value() != b.has_value() || (a.has_value() &&
+                (a->primitiveId != b->primitiveId || std::abs(a->record.t - b->record.t) > static_cast<hvk::Real>(1e-4) * b->record.t)))
+            {
+                ++mismatches;
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+    const auto parsedOptions = parseOptions(argc, argv);
+    if (!parsedOptions.has_value())
+    {
+        std::cerr << "usage: " << argv[0] << " [--samples N] [--threads N] [--scene NAME] [--references DIR] > results.json\n"
+                  << "       " << argv[0] << " --write-references DIR [--samples N] [--scene NAME]" << std::endl;
+        return 1;
+    }
+    const BenchOptions& options = parsedOptions.value();
+    if (options.sceneName.has_value() &&
+        std::none_of(hvk::scenes::kCanonical.begin(), hvk::scenes::kCanonical.end(), [&](const auto& canonical)
+        {
+            return options.sceneName.value() == canonical.name;
+        }))
+    {
+        std::cerr << "Unknown scene " << options.sceneName.value() << std::endl;
+        return 1;
+    }
+
+    const auto aspectRatio = static_cast<hvk::Real>(kImageWidth) / kImageHeight;
+    hvk::ThreadPool pool(options.numThreads);
+
+    if (!options.writeReferences)
+    {
+        std::cout << "{\n"
+                  << "  \"width\": " << kImageWidth << ",\n"
+                  << "  \"height\": " << kImageHeight << ",\n"
+                  << "  \"samplesPerPixel\": " << options.numSamples << ",\n"
+                  << "  \"threads\": " << pool.getNumThreads() << ",\n"
+                  << "  \"scenes\": [";
+    }
+    bool firstScene = true;
+    for (const auto& canonical : hvk::scenes::kCanonical)
+    {
+        if (options.sceneName.has_value() && options.sceneName.value() != canonical.name)
+        {
+            continue;
+        }
+
+        entt::registry registry;
+        const hvk::Camera camera = canonical.build(registry, aspectRatio);
+
+        const auto buildStart = std::chrono::steady_clock::now();
+        hvk::Scene scene(registry);
+        scene.Build(&pool, kBuildQuality);
+        const auto buildEnd = std::chrono::steady_clock::now();
+
+        hvk::stats::Reset();
+        const hvk::Image image = { kImageWidth, kImageHeight, renderImage(scene, camera, options.numSamples, pool) };
+        const auto renderEnd = std::chrono::steady_clock::now();
+        const auto counters = hvk::stats::Collect();
+
+        const double buildMs = std::chrono::duration<double, std::milli>(buildEnd - buildStart).count();
+        const double renderSeconds = std::chrono::duration<double>(renderEnd - buildEnd).count();
+
+        std::cerr << canonical.name << ": build " << buildMs << " ms, render " << renderSeconds * 1000.0 << " ms" << std::endl;
+
+        // the spheres move on after the image, so it stays comparable
+        double updateMs = 0.0;
+        size_t mismatches = 0;
+        for (uint16_t frame = 0; frame < kUpdateFrames; ++frame)
+        {
+            moveSpheres(registry, frame);
+            const auto updateStart = std::chrono::steady_clock::now();
+            scene.Update(&pool);
+            updateMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
+
+            hvk::Scene fresh(registry);
+            fresh.Build(&pool, kBuildQuality);
+            mismatches += countMismatches(scene, fresh, camera);
+        }
+        updateMs /= kUpdateFrames;
+        if (mismatches > 0)
+        {
+            std::cerr << canonical.name << ": " << mismatches << " rays hit differently after Scene::Update than after a fresh build" << std::endl;
+            return 1;
+        }
+
+        const std::string referencePath = options.referencePath.value_or("") + "/" + canonical.name + ".ppm";
+        if (options.writeReferences)
+        {
+            std::ofstream file(referencePath, std::ios::trunc);
+            hvk::WriteImage(file, image.pixels, image.width, image.height);
+            if (!file)
+            {
+                std::cerr << "Failed to write " << referencePath << std::endl;
+                return 1;
+            }
+            continue;
+        }
+
+        // error against the reference, if there is one of the same size
+        std::optional<hvk::ImageError> error;
+        if (options.referencePath.has_value())
+        {
+            std::ifstream file(referencePath, std::ios::binary);
+            const auto reference = hvk::ReadImage(file);
+            error = reference.has_value() ? hvk::CompareImages(image, reference.value()) : std::nullopt;
+            if (!error.has_value())
+            {
+                std::cerr << "No " << kImageWidth << "x" << kImageHeight << " reference at " << referencePath << std::endl;
+            }
+        }
+
+        const uint64_t numSamples = static_cast<uint64_t>(kImageWidth) * kImageHeight * options.numSamples;
+        const uint64_t numRays = counters.cameraRays + counters.bounceRays;
+        std::cout << (firstScene ? "\n" : ",\n")
+                  << "    {\n"
+                  << "      \"name\": \"" << canonical.name << "\",\n"
+                  << "      \"buildMs\": " << buildMs << ",\n"
+                  << "      \"updateMs\": " << updateMs << ",\n"
+                  << "      \"renderMs\": " << renderSeconds * 1000.0 << ",\n"
+                  << "      \"msamplesPerSecond\": " << numSamples / renderSeconds / 1e6 << ",\n";
+        // rays are only known with the counters compiled in
+        if (hvk::stats::kEnabled && numRays > 0)
+        {
+            std::cout << "      \"mraysPerSecond\": " << numRays / renderSeconds / 1e6 << ",\n"
+                      << "      \"primitiveTestsPerRay\": " << static_cast<double>(counters.primitiveTests) / numRays << ",\n"
+                      << "      \"nodeVisitsPerRay\": " << static_cast<double>(counters.nodeVisits) / numRays << ",\n";
+        }
+        else
+        {
+            std::cout << "      \"mraysPerSecond\": null,\n"
+                      << "      \"primitiveTestsPerRay\": null,\n"
+                      << "      \"nodeVisitsPerRay\": null,\n";
+        }
+        if (error.has_value())
+        {
+            std::cout << "      \"rmse\": " << error->rmse << ",\n"
+                      << "      \"relativeMSE\": " << error->relativeMSE << ",\n"
+                      << "      \"psnr\": " << hvk::JsonNumber(error->psnr) << ",\n"
+                      << "      \"efficiency\": " << hvk::JsonNumber(hvk::Efficiency(error.value(), renderSeconds));
+        }
+        else
+        {
+            std::cout << "      \"rmse\": null,\n"
+                      << "      \"relativeMSE\": null,\n"
+                      << "      \"psnr\": null,\n"
+                      << "      \"efficiency\": null";
+        }
+        std::cout << "\n    }";
+        firstScene = false;
+    }
+    if (!options.writeReferences)
+    {
+        std::cout << "\n  ]\n}" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+// rtx_compare measures how far a render is from a reference rendered with
+// many more samples, as JSON: RMSE, relative MSE and PSNR of the whole image
+// and relative MSE per tile, see ImageMetrics.h. Given the render time it also
+// prints the efficiency, 1 / (relative MSE * seconds), which is what a change
+// to sampling or denoising should raise.
+//
+// rtx_weekend normally writes a mosaic of the image and its G-buffer, which
+// would be scored too, so render both images with --beauty-only:
+//
+//  rtx_weekend --beauty-only --samples 4096 > reference.ppm
+//  rtx_weekend --beauty-only --samples 16 --denoise > image.ppm
+//  rtx_compare IMAGE REFERENCE [--seconds S] [--tile N] [--error-map PATH] > results.json
+//
+// where S is the render time rtx_weekend reports, or the render and denoise
+// times together.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Float3.h"
+#include "Image.h"
+#include "ImageMetrics.h"
+
+const uint16_t kDefaultTileSize = 16;
+
+struct CompareOptions
+{
+    std::string imagePath;
+    std::string referencePath;
+    // render time of the image, for its efficiency
+    std::optional<double> seconds;
+    uint16_t tileSize;
+    // where the per tile error is written as a heatmap PPM
+    std::optional<std::string> errorMapPath;
+};
+
+std::optional<CompareOptions> parseOptions(int argc, char** argv)
+{
+    // every option takes a value
+    if (argc < 3 || (argc - 3) % 2 != 0)
+    {
+        return std::nullopt;
+    }
+    CompareOptions options = { argv[1], argv[2], std::nullopt, kDefaultTileSize, std::nullopt };
+    for (int i = 3; i < argc; i += 2)
+    {
+        const char* argument = argv[i];
+        const char* value = argv[i + 1];
+        char* end = nullptr;
+        if (std::strcmp(argument, "--seconds") == 0)
+        {
+            const double seconds = std::strtod(value, &end);
+            if (end == value || *end != '\0' || !(seconds > 0.0))
+            {
+                return std::nullopt;
+            }
+            options.seconds = seconds;
+        }
+        else if (std::strcmp(argument, "--tile") == 0)
+        {
+            const unsigned long tileSize = std::strtoul(value, &end, 10);
+            if (end == value || *end != '\0' || value[0] == '-' || tileSize == 0 || tileSize > UINT16_MAX)
+            {
+                return std::nullopt;
+            }
+            options.tileSize = static_cast<uint16_t>(tileSize);
+        }
+        else if (std::strcmp(argument, "--error-map") == 0)
+        {
+            options.errorMapPath = std::string(value);
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+std::optional<hvk::Image> readImage(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    auto image = hvk::ReadImage(file);
+    if (!image.has_value())
+    {
+        std::cerr << "Failed to read a PPM from " << path << std::endl;
+    }
+    return image;
+}
+
+// every pixel of a tile gets its relative MSE on the heatmap ramp, white at
+// the worst tile, like rtx_weekend's cost heatmap
+std::vector<hvk::Float3> errorMap(const std::vector<hvk::ImageError>& tiles, uint16_t width, uint16_t height, uint16_t tileSize)
+{
+    double maxError = 0.0;
+    for (const auto& tile : tiles)
+    {
+        maxError = std::max(maxError, tile.relativeMSE);
+    }
+    std::cerr << "Error map: white is relative MSE " << maxError << std::endl;
+
+    const size_t tilesX = (width + tileSize - 1) / tileSize;
+    std::vector<hvk::Float3> colors(static_cast<size_t>(width) * height);
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            const auto& tile = tiles[(y / tileSize) * tilesX + x / tileSize];
+            colors[y * width + x] = hvk::HeatColor(maxError > 0.0 ? static_cast<float>(tile.relativeMSE / maxError) : 0.f);
+        }
+    }
+    return colors;
+}
+
+int main(int argc, char** argv)
+{
+    const auto parsedOptions = parseOptions(argc, argv);
+    if (!parsedOptions.has_value())
+    {
+        std::cerr << "usage: " << argv[0] << " IMAGE REFERENCE [--seconds S] [--tile N] [--error-map PATH] > results.json" << std::endl;
+        return 1;
+    }
+    const CompareOptions& options = parsedOptions.value();
+
+    const auto image = readImage(options.imagePath);
+    const auto reference = readImage(options.referencePath);
+    if (!image.has_value() || !reference.has_value())
+    {
+        return 1;
+    }
+    const auto error = hvk::CompareImages(image.value(), reference.value());
+    const auto tiles = hvk::CompareTiles(image.value(), reference.value(), options.tileSize);
+    if (!error.has_value() || !tiles.has_value())
+    {
+        std::cerr << "The image is " << image->width << "x" << image->height
+                  << " but the reference is " << reference->width << "x" << reference->height << std::endl;
+        return 1;
+    }
+
+    const size_t tilesX = (image->width + options.tileSize - 1) / options.tileSize;
+    const size_t tilesY = (image->height + options.tileSize - 1) / options.tileSize;
+    std::cout << "{\n"
+              << "  \"width\": " << image->width << ",\n"
+              << "  \"height\": " << image->height << ",\n"
+              << "  \"rmse\": " << error->rmse << ",\n"
+              << "  \"relativeMSE\": " << error->relativeMSE << ",\n"
+              << "  \"psnr\": " << hvk::JsonNumber(error->psnr) << ",\n"
+              << "  \"seconds\": " << (options.seconds.has_value() ? hvk::JsonNumber(options.seconds.value()) : "null") << ",\n"
+              << "  \"efficiency\": "
+              << (options.seconds.has_value() ? hvk::JsonNumber(hvk::Efficiency(error.value(), options.seconds.value())) : "null") << ",\n"
+              << "  \"tileSize\": " << options.tileSize << ",\n"
+              << "  \"tilesX\": " << tilesX << ",\n"
+              << "  \"tilesY\": " << tilesY << ",\n"
+              << "  \"tileRelativeMSE\": [";
+    // rows of tiles top down
+    for (size_t tileY = 0; tileY < tilesY; ++tileY)
+    {
+        std::cout << (tileY == 0 ? "\n    [" : ",\n    [");
+        for (size_t tileX = 0; tileX < tilesX; ++tileX)
+        {
+            std::cout << (tileX == 0 ? "" : ", ") << tiles->at(tileY * tilesX + tileX).relativeMSE;
+        }
+        std::cout << "]";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+
+    if (options.errorMapPath.has_value())
+    {
+        std::ofstream file(options.errorMapPath.value(), std::ios::trunc);
+        hvk::WriteImage(file, errorMap(tiles.value(), image->width, image->height, options.tileSize), image->width, image->height);
+        if (!file)
+        {
+            std::cerr << "Failed to write " << options.errorMapPath.value() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
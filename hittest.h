@@ -1,6 +1,9 @@
 #ifndef RTX_WEEKEND_HITTEST_H
 #define RTX_WEEKEND_HITTEST_H
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <optional>
 #include <utility>
 
@@ -9,6 +12,11 @@
 #include "Sphere.h"
 #include "Plane.h"
 #include "Box.h"
+#include "Quad.h"
+#include "Disc.h"
+#include "AABB.h"
+#include "Real.h"
+#include "RayStats.h"
 
 namespace hvk
 {
@@ -19,8 +27,10 @@ namespace hvk
 
         };
 
-        std::optional<float> SphereRayIntersect(const Sphere& sphere, const Ray& ray)
+        inline std::optional<Real> SphereRayIntersect(const Sphere& sphere, const Ray& ray)
         {
+            RTX_WEEKEND_COUNT(primitiveTests, 1);
+
             // This is the quadratic equation:
             //  (V . V)t^2 + (S . V)t + (S . S) - r^2 = 0
             // Where:
@@ -35,22 +45,22 @@ namespace hvk
             //  x^2 + y^2 + z^2 = r^2
 
             const Vector rayToSphere = ray.getOrigin() - sphere.getCenter();
-            const auto r = sphere.getRadius();
-            const auto a = 1.f; // Ray direction is normalized, so dot(R, R) will always be 1
-            const auto b = 2.0 * Vector::Dot(rayToSphere, ray.getDirection());
-            const auto rtsDot = Vector::Dot(rayToSphere, rayToSphere);
-            const auto c = rtsDot - r * r;
-            const auto discriminant = b*b - 4*a*c;
+            const Real r = sphere.getRadius();
+            const Real a = 1; // Ray direction is normalized, so dot(R, R) will always be 1
+            const Real b = 2 * static_cast<Real>(Vector::Dot(rayToSphere, ray.getDirection()));
+            const Real rtsDot = Vector::Dot(rayToSphere, rayToSphere);
+            const Real c = rtsDot - r * r;
+            const Real discriminant = b*b - 4*a*c;
             if (discriminant > 0)
             {
-                float root = sqrt(discriminant);
+                Real root = std::sqrt(discriminant);
                 const auto epsilon = std::numeric_limits<decltype(root)>::epsilon();
-                float rootOne = (-b - root) / (2.0 * a);
-                float rootTwo = (-b + root) / (2.0 * a);
+                Real rootOne = (-b - root) / (2 * a);
+                Real rootTwo = (-b + root) / (2 * a);
 //                return std::optional{ std::min(rootOne, rootTwo) };
                 if (rootOne > epsilon && rootTwo > epsilon)
                 {
-                    float closestRoot = std::min(rootOne, rootTwo);
+                    Real closestRoot = std::min(rootOne, rootTwo);
                     return std::optional{ closestRoot };
                 }
                 else if (rootOne > epsilon)
@@ -65,8 +75,10 @@ namespace hvk
             return std::nullopt;
         }
 
-        std::optional<float> PlaneRayIntersect(const Plane& plane, const Ray& ray)
+        inline std::optional<Real> PlaneRayIntersect(const Plane& plane, const Ray& ray)
         {
+            RTX_WEEKEND_COUNT(primitiveTests, 1);
+
             // The implicit form of a plane is:
             //  (P1 - P0) . N = 0
             // Where:
@@ -85,20 +97,21 @@ namespace hvk
 
             const auto denominator = Vector::Dot(ray.getDirection(), plane.getDirection());
             const auto epsilon = std::numeric_limits<decltype(denominator)>::epsilon();
-            if (abs(denominator) > epsilon)
+            if (std::abs(denominator) > epsilon)
             {
-                const auto numerator = Vector::Dot(plane.getOrigin() - ray.getOrigin(), plane.getDirection());
+                const Real numerator = Vector::Dot(plane.getOrigin() - ray.getOrigin(), plane.getDirection());
                 return std::optional { numerator / denominator };
             }
 
             return std::nullopt;
         }
 
-        std::optional<std::pair<Side, float>> BoxRayIntersect(const Box& box, const Ray& ray)
+        inline std::optional<std::pair<Side, Real>> BoxRayIntersect(const Box& box, const Ray& ray)
         {
             // Box intersection is done by first finding a plane which
             // the ray intersects with, and then checking if that point
             // is "inside" each of the box's other planes
+            // (each side tested counts as a plane test)
 
             const auto& sides = box.getSides();
 
@@ -148,6 +161,84 @@ namespace hvk
 
             return std::nullopt;
         }
+
+        inline std::optional<Real> QuadRayIntersect(const Quad& quad, const Ray& ray)
+        {
+            RTX_WEEKEND_COUNT(primitiveTests, 1);
+
+            // Intersect the quad's plane, then express the hit point P relative
+            // to the corner Q in terms of the edges U and V:
+            //  P - Q = aU + bV
+            // Crossing both sides with V or U and dotting with W = N / (N . N),
+            // where N = U x V, gives:
+            //  a = W . ((P - Q) x V)
+            //  b = W . (U x (P - Q))
+            // and the point is inside when both lie in [0, 1]
+
+            const auto n = Vector::Cross(quad.getU(), quad.getV());
+            const auto denominator = Vector::Dot(ray.getDirection(), n);
+            const auto epsilon = std::numeric_limits<decltype(denominator)>::epsilon();
+            if (std::abs(denominator) <= epsilon)
+            {
+                return std::nullopt;
+            }
+
+            const Real t = static_cast<Real>(Vector::Dot(quad.getCorner() - ray.getOrigin(), n)) / denominator;
+            const auto planar = ray.PointAt(t) - quad.getCorner();
+            const auto w = n / Vector::Dot(n, n);
+            const float a = Vector::Dot(w, Vector::Cross(planar, quad.getV()));
+            const float b = Vector::Dot(w, Vector::Cross(quad.getU(), planar));
+            if (a < 0.f || a > 1.f || b < 0.f || b > 1.f)
+            {
+                return std::nullopt;
+            }
+            return std::optional{ t };
+        }
+
+        inline std::optional<Real> DiscRayIntersect(const Disc& disc, const Ray& ray)
+        {
+            RTX_WEEKEND_COUNT(primitiveTests, 1);
+
+            // Intersect the disc's plane, then check the distance to the center
+
+            const auto denominator = Vector::Dot(ray.getDirection(), disc.getNormal());
+            const auto epsilon = std::numeric_limits<decltype(denominator)>::epsilon();
+            if (std::abs(denominator) <= epsilon)
+            {
+                return std::nullopt;
+            }
+
+            const Real t = static_cast<Real>(Vector::Dot(disc.getCenter() - ray.getOrigin(), disc.getNormal())) / denominator;
+            const auto fromCenter = ray.PointAt(t) - disc.getCenter();
+            const float r = disc.getRadius();
+            if (Vector::Dot(fromCenter, fromCenter) > r * r)
+            {
+                return std::nullopt;
+            }
+            return std::optional{ t };
+        }
+
+        inline std::optional<float> AABBRayIntersect(
+                const AABB& bounds,
+                const Vector& origin,
+                const Vector& inverseDirection,
+                float tMax)
+        {
+            // Slab test: the ray is inside the box over the overlap of the
+            // [near, far] intervals it spends between each pair of axis planes
+
+            const Vector t0 = (bounds.getMin() - origin) * inverseDirection;
+            const Vector t1 = (bounds.getMax() - origin) * inverseDirection;
+            const Vector tNear = Vector::Min(t0, t1);
+            const Vector tFar = Vector::Max(t0, t1);
+            const float enter = std::max(std::max(tNear.X(), tNear.Y()), std::max(tNear.Z(), 0.f));
+            const float exit = std::min(std::min(tFar.X(), tFar.Y()), std::min(tFar.Z(), tMax));
+            if (enter <= exit)
+            {
+                return std::optional{ enter };
+            }
+            return std::nullopt;
+        }
     }
 }
 
@@ -1,6 +1,14 @@
 #include <iostream>
+#include <chrono>
 #include <vector>
 #include <optional>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
 
 #if defined(WIN32)
 #include <DirectXMath.h>
@@ -19,182 +27,248 @@ using namespace DirectX;
 #include "Box.h"
 #include "ThreadPool.h"
 #include "Camera.h"
+#include "Scene.h"
+#include "RayPacket.h"
+#include "Integrator.h"
+#include "Wavefront.h"
+#include "NodeCacheSimulator.h"
+#include "SPMDIntegrator.h"
+#include "Float3.h"
+#include "GBuffer.h"
+#include "Denoiser.h"
+#include "RenderBudget.h"
+#include "Options.h"
+#include "AccumulationBuffer.h"
+#include "TileCoordinator.h"
+#include "TileWorker.h"
+#include "Hash.h"
+#include "RayStats.h"
+#include "PathStats.h"
+#include "Trace.h"
+#include "Scenes.h"
+#include "Image.h"
 
 using Color = hvk::Vector;
 
-const hvk::Vector kSkyColor1 = hvk::Vector(1.f, 1.f, 1.f);
-const hvk::Vector kSkyColor2 = hvk::Vector(0.5f, 0.7f, 1.f);
-
 const uint16_t kNumSamples = 200;
-const uint16_t kMaxRayDepth = 50;
+
+// progressive renders add this many samples per pixel to the whole image per pass
+const uint16_t kPassSamples = 8;
 
 const double kMinDepth = 0.01f;
 const double kMaxDepth = 5.f;
 
-const double kIORAir = 1.f;
-
 const uint8_t kNumThreads = 24;
 
-struct RayTestResult
+// Depth, normal and albedo only need the first hit, so they come from a
+// separate G-buffer pass with far fewer samples than the beauty render
+const uint16_t kGBufferSamples = 8;
+
+// passes of the filter run with --denoise, see Denoiser
+const uint8_t kDenoiseIterations = 5;
+
+// Fast trades some trace performance for much quicker rebuilds
+const hvk::BVHBuildQuality kBuildQuality = hvk::BVHBuildQuality::High;
+
+enum class Kernel
 {
-    Color image;
-    Color reflect;
-    Color normal;
-    Color hit;
-    double depth;
+    // depth first, one task per scanline with packet traced primary rays
+    Scalar,
+    // breadth first over the samples of a tile, see WavefrontIntegrator
+    Wavefront,
+    // eight pixels' paths at a time in AVX2 lanes, see SPMDIntegrator.
+    // Needs a build with RTX_WEEKEND_AVX2, otherwise Scalar runs instead
+    SPMD
 };
+const Kernel kKernel = Kernel::Scalar;
 
+// wavefront and SPMD kernels hand out square tiles of this many pixels a side
+const uint16_t kTileSize = 16;
 
-Color rayColor(const hvk::Ray& r, entt::registry& registry, int depth, std::optional<RayTestResult>& outResult)
+// wavefront kernel only: sort secondary rays by direction and origin each bounce
+const bool kReorderRays = true;
+// samples per pixel traced together in one wavefront
+const uint16_t kWavefrontSamples = 8;
+
+// feed BVH node fetches through a cache model and report its miss rate
+const bool kSimulateNodeCache = false;
+
+// a coordinator hands out square tiles of this many pixels a side, a whole
+// number of kTileSize tiles so that workers never split one
+const uint16_t kServerTileSize = 4 * kTileSize;
+
+// columns and rows, top down, of part of the image, ends exclusive
+struct PixelRect
 {
-    if (depth <=0)
-    {
-        return Color(0.f, 0.f, 0.f);
-    }
+    uint16_t columnBegin;
+    uint16_t columnEnd;
+    uint16_t rowBegin;
+    uint16_t rowEnd;
+};
 
-    hvk::HitRecord earliestHitRecord = {};
-    earliestHitRecord.t = std::numeric_limits<double>::max();
-    hvk::Material earliestMaterial(hvk::MaterialType::Diffuse, hvk::Color(0.f, 0.f, 0.f), -1.f);
+// set by the SIGINT handler, stops a progressive render after the work in flight
+std::atomic<bool> gCancelRequested = false;
 
-    auto sphereView = registry.view<hvk::Sphere, hvk::Material>();
-    for (const auto entity : sphereView)
-    {
-        const auto& sphere = sphereView.get<hvk::Sphere>(entity);
-        const auto& material = sphereView.get<hvk::Material>(entity);
-        auto intersection = hvk::hit::SphereRayIntersect(sphere, r);
-        if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < earliestHitRecord.t)
-        {
-            earliestHitRecord.t = intersection.value();
-            earliestHitRecord.point = r.PointAt(earliestHitRecord.t);
-            earliestHitRecord.normal = (earliestHitRecord.point - sphere.getCenter()).Normalized();
-//            if (hvk::Vector::Dot(earliestHitRecord.normal, r.getDirection().Normalized()) > 0.f)
-//            {
-//                int blah = 5 + 5;
-//                std::cout << blah << std::endl;
-//            }
-            earliestMaterial = material;
-        }
-    }
+// Only the first SIGINT asks for the image so far, a second one kills the process
+void onInterrupt(int)
+{
+    std::signal(SIGINT, SIG_DFL);
+    gCancelRequested = true;
+}
 
-    // test for plane intersections
-    auto planeView = registry.view<hvk::Plane, hvk::Material>();
-    for (const auto entity : planeView)
+// Replaces the image at path as a whole, so that readers never see half of one
+void publishImage(const std::string& path, const std::vector<hvk::Float3>& colors, uint16_t width, uint16_t height)
+{
+    RTX_WEEKEND_TRACE_SCOPE("Publish");
+    const std::string temporaryPath = path + ".tmp";
     {
-        const auto& plane = planeView.get<hvk::Plane>(entity);
-        const auto& material = planeView.get<hvk::Material>(entity);
-        auto intersection = hvk::hit::PlaneRayIntersect(plane, r);
-        if (intersection.has_value() && intersection.value() > 0.f && intersection.value() < earliestHitRecord.t)
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        hvk::WriteImage(file, colors, width, height);
+        if (!file)
         {
-            earliestHitRecord.t = intersection.value();
-            earliestHitRecord.point = r.PointAt(earliestHitRecord.t);
-            earliestHitRecord.normal = plane.getDirection().Normalized();
-            earliestMaterial = material;
+            std::cerr << "Failed to write " << temporaryPath << std::endl;
+            return;
         }
     }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::cerr << "Failed to publish " << path << ": " << error.message() << std::endl;
+    }
+}
 
-    // test for box intersections
-    // on a successful hit test we'll need:
-    //  t
-    //  the normal of the plane the intersection occurs at
-     auto boxView = registry.view<hvk::Box, hvk::Material>();
-     for (const auto entity : boxView)
-     {
-         const auto& box = boxView.get<hvk::Box>(entity);
-         const auto& material = boxView.get<hvk::Material>(entity);
-         auto intersection = hvk::hit::BoxRayIntersect(box, r);
-         if (intersection.has_value() && intersection.value().second > 0.f && intersection.value().second < earliestHitRecord.t)
-         {
-             earliestHitRecord.t = intersection.value().second;
-             earliestHitRecord.point = r.PointAt(earliestHitRecord.t);
-             earliestHitRecord.normal = box.getSide(intersection.value().first).getDirection().Normalized();
-             earliestMaterial = material;
-         }
-     }
-
-    if (earliestHitRecord.t < std::numeric_limits<double>::max())
+// indexed like PathCounters
+const std::array<const char*, hvk::kNumPathEnds> kPathEndNames = { "sky", "depthLimit", "failedReflection", "absorbed" };
+const std::array<const char*, hvk::kNumMaterialTypes + 1> kPathMaterialNames = { "diffuse", "metal", "dielectric", "none" };
+
+// Prints what the rays of a render cost and how its paths ended, and writes
+// the same to jsonPath if given
+void reportRayStats(
+        const hvk::RayCounters& counters,
+        const hvk::PathCounters& paths,
+        double seconds,
+        const std::optional<std::string>& jsonPath)
+{
+    const uint64_t rays = counters.cameraRays + counters.bounceRays;
+    const auto perSecond = [seconds](uint64_t count)
     {
-        if (depth == kMaxRayDepth && outResult.has_value())
-        {
-            auto& result = outResult.value();
-            result.hit += earliestHitRecord.point;
-            result.depth += earliestHitRecord.t;
-            result.normal += 0.5f * Color(
-                    earliestHitRecord.normal.X() + 1,
-                    earliestHitRecord.normal.Y() + 1,
-                    earliestHitRecord.normal.Z() + 1);
-            auto reflected = hvk::Vector::Reflect(r.getDirection(), earliestHitRecord.normal);
-            result.reflect += 0.5f * Color(reflected.X() + 1, reflected.Y() + 1, reflected.Z() + 1);
-            result.image += Color(0.f, 0.f, 0.f);
-        }
+        return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+    };
+    const auto perRay = [rays](uint64_t count)
+    {
+        return rays > 0 ? static_cast<double>(count) / static_cast<double>(rays) : 0.0;
+    };
+
+    std::cerr << "Rays: " << rays << " (" << counters.cameraRays << " camera, " << counters.bounceRays << " bounce), "
+              << perSecond(rays) / 1e6 << " Mrays/s, " << perSecond(counters.cameraRays) / 1e6 << " Msamples/s, "
+              << perRay(counters.primitiveTests) << " primitive tests and "
+              << perRay(counters.nodeVisits) << " BVH node visits per ray" << std::endl;
 
-        hvk::Ray scattered = hvk::Ray(hvk::Vector(), hvk::Vector());
-        hvk::Color attenuation(0.f, 0.f, 0.f);
-        bool shouldContinue = false;
-        if (earliestMaterial.getType() == hvk::MaterialType::Diffuse)
+    // one line per way of ending, split by the last surface hit, with the mean and longest path length
+    uint64_t numPaths = 0;
+    for (const auto& byMaterial : paths.paths)
+    {
+        for (const auto& byBounces : byMaterial)
         {
-            shouldContinue = hvk::ScatterDiffuse(r, earliestMaterial, earliestHitRecord, attenuation, scattered);
+            for (const auto count : byBounces)
+            {
+                numPaths += count;
+            }
         }
-        else if (earliestMaterial.getType() == hvk::MaterialType::Metal)
+    }
+    std::cerr << "Paths: " << numPaths << std::endl;
+    for (size_t end = 0; end < hvk::kNumPathEnds; ++end)
+    {
+        uint64_t endPaths = 0;
+        uint64_t totalBounces = 0;
+        size_t maxBounces = 0;
+        std::array<uint64_t, hvk::kNumMaterialTypes + 1> materialPaths = {};
+        for (size_t material = 0; material <= hvk::kNumMaterialTypes; ++material)
         {
-            shouldContinue = hvk::ScatterMetal(r, earliestMaterial, earliestHitRecord, attenuation, scattered);
-            if (!shouldContinue)
+            for (size_t bounces = 0; bounces <= hvk::kMaxRayDepth; ++bounces)
             {
-                return hvk::Color(0.f, 0.f, 1.f);
+                const uint64_t count = paths.paths[end][material][bounces];
+                materialPaths[material] += count;
+                totalBounces += count * bounces;
+                maxBounces = count > 0 ? std::max(maxBounces, bounces) : maxBounces;
             }
+            endPaths += materialPaths[material];
         }
-        else if (earliestMaterial.getType() == hvk::MaterialType::Dielectric)
+        if (endPaths == 0)
         {
-            shouldContinue = hvk::ScatterDielectric(r, earliestMaterial, kIORAir, earliestHitRecord, attenuation, scattered);
+            continue;
         }
 
-        if (shouldContinue)
+        std::cerr << "  " << kPathEndNames[end] << ": " << (100.0 * endPaths / numPaths) << "%, after";
+        for (size_t material = 0; material <= hvk::kNumMaterialTypes; ++material)
         {
-//            // add biasing
-//            scattered = hvk::Ray(scattered.getOrigin() + (0.01) * earliestHitRecord.normal.Normalized(), scattered.getDirection());
-            return attenuation * rayColor(scattered, registry, depth-1, outResult);
+            std::cerr << (material == 0 ? " " : ", ") << kPathMaterialNames[material] << " " << materialPaths[material];
         }
+        std::cerr << "; " << static_cast<double>(totalBounces) / endPaths << " bounces on average, at most "
+                  << maxBounces << std::endl;
+    }
 
-        return hvk::Color(0.f, 0.f, 0.f);
+    if (!jsonPath.has_value())
+    {
+        return;
     }
-    else
+    std::ofstream file(jsonPath.value(), std::ios::trunc);
+    file << "{\n"
+         << "  \"seconds\": " << seconds << ",\n"
+         << "  \"cameraRays\": " << counters.cameraRays << ",\n"
+         << "  \"bounceRays\": " << counters.bounceRays << ",\n"
+         << "  \"primitiveTests\": " << counters.primitiveTests << ",\n"
+         << "  \"nodeVisits\": " << counters.nodeVisits << ",\n"
+         << "  \"raysPerSecond\": " << perSecond(rays) << ",\n"
+         << "  \"samplesPerSecond\": " << perSecond(counters.cameraRays) << ",\n"
+         << "  \"primitiveTestsPerRay\": " << perRay(counters.primitiveTests) << ",\n"
+         << "  \"nodeVisitsPerRay\": " << perRay(counters.nodeVisits) << ",\n";
+
+    // paths[end][last material] lists the number of paths by bounce count
+    file << "  \"paths\": {";
+    for (size_t end = 0; end < hvk::kNumPathEnds; ++end)
     {
-        hvk::Vector unitDirection = r.getDirection();
-        auto t = (unitDirection.Y() + 1.f) * 0.5f;
-        return (kSkyColor1 * (1.0 - t)) + (kSkyColor2 * t);
+        file << (end == 0 ? "\n" : ",\n") << "    \"" << kPathEndNames[end] << "\": {";
+        for (size_t material = 0; material <= hvk::kNumMaterialTypes; ++material)
+        {
+            file << (material == 0 ? "\n" : ",\n") << "      \"" << kPathMaterialNames[material] << "\": [";
+            for (size_t bounces = 0; bounces <= hvk::kMaxRayDepth; ++bounces)
+            {
+                file << (bounces == 0 ? "" : ", ") << paths.paths[end][material][bounces];
+            }
+            file << "]";
+        }
+        file << "\n    }";
+    }
+    file << "\n  }\n"
+         << "}\n";
+    if (!file)
+    {
+        std::cerr << "Failed to write " << jsonPath.value() << std::endl;
     }
-}
-
-void writeColor(const Color& c)
-{
-    auto ir = static_cast<int>(255.999 * c.X());
-    auto ig = static_cast<int>(255.999 * c.Y());
-    auto ib = static_cast<int>(255.999 * c.Z());
-
-    std::cout << ir << ' ' << ig << ' ' << ib << std::endl;
 }
 
 void writeBuffers(
-        const std::vector<Color>& colors,
+        const std::vector<hvk::Float3>& colors,
         uint16_t imageWidth,
         uint16_t imageHeight,
-        const std::optional<std::vector<double>>& depth,
-        const std::optional<std::vector<Color>>& normals,
-        const std::optional<std::vector<Color>>& reflects,
-        const std::optional<std::vector<Color>>& hits)
+        const std::optional<std::vector<float>>& depth,
+        const std::optional<std::vector<hvk::Float3>>& normals,
+        const std::optional<std::vector<hvk::Float3>>& albedo,
+        const std::optional<std::vector<float>>& cost)
 {
-std::vector<std::vector<Color>> buffers;
+    RTX_WEEKEND_TRACE_SCOPE("Output");
+std::vector<std::vector<hvk::Float3>> buffers;
     buffers.push_back(colors);
 
-    // buffers.push_back(depth);
-    // buffers.push_back(normals);
-    // buffers.push_back(reflects);
     if (depth.has_value())
     {
         // prepare depth buffer as colors
-        std::vector<Color> depthColors;
+        std::vector<hvk::Float3> depthColors;
         depthColors.resize(depth->size());
-        double minDepth = std::numeric_limits<double>().max();
-        double maxDepth = std::numeric_limits<double>().min();
+        float minDepth = std::numeric_limits<float>().max();
+        float maxDepth = std::numeric_limits<float>().min();
         for (auto d : depth.value())
         {
             if (d < minDepth)
@@ -208,22 +282,43 @@ std::vector<std::vector<Color>> buffers;
         }
         for (size_t i = 0; i < depthColors.size(); ++i)
         {
-            const double c = (depth->at(i) - minDepth) / (maxDepth - minDepth);
-            depthColors[i] = Color(c, c, c);
+            const float c = (depth->at(i) - minDepth) / (maxDepth - minDepth);
+            depthColors[i] = hvk::Float3(c, c, c);
         }
         buffers.push_back(depthColors);
     }
     if (normals.has_value())
     {
-        buffers.push_back(normals.value());
+        // map unit normals into [0, 1]
+        std::vector<hvk::Float3> normalColors;
+        normalColors.reserve(normals->size());
+        for (const auto& n : normals.value())
+        {
+            normalColors.emplace_back(0.5f * (n.x + 1.f), 0.5f * (n.y + 1.f), 0.5f * (n.z + 1.f));
+        }
+        buffers.push_back(normalColors);
     }
-    if (reflects.has_value())
+    if (albedo.has_value())
     {
-        buffers.push_back(reflects.value());
+        buffers.push_back(albedo.value());
     }
-    if (hits.has_value())
+    if (cost.has_value())
     {
-        buffers.push_back(hits.value());
+        // black through red and yellow to white, which is the 99th percentile
+        // so that a few slow pixels don't leave the rest black
+        std::vector<float> sorted = cost.value();
+        const auto percentile = sorted.begin() + (sorted.size() * 99) / 100;
+        std::nth_element(sorted.begin(), percentile, sorted.end());
+        const float maxCost = percentile != sorted.end() ? *percentile : 0.f;
+        std::cerr << "Cost heatmap: white is " << maxCost << " ms per pixel or more" << std::endl;
+
+        std::vector<hvk::Float3> costColors;
+        costColors.reserve(cost->size());
+        for (const auto c : cost.value())
+        {
+            costColors.push_back(hvk::HeatColor(maxCost > 0.f ? c / maxCost : 0.f));
+        }
+        buffers.push_back(costColors);
     }
 
     const auto numColumns = static_cast<uint16_t>(std::ceil(sqrt(buffers.size())));
@@ -231,9 +326,7 @@ std::vector<std::vector<Color>> buffers;
     const uint16_t width = imageWidth * numColumns;
     const uint16_t height = imageHeight * numRows;
 
-    std::cout << "P3\n" << width << ' ' << height << "\n255\n";
-
-    std::vector<Color> finalBuffer;
+    std::vector<hvk::Float3> finalBuffer;
     finalBuffer.resize(width * height);
 
     size_t row = 0;
@@ -246,12 +339,12 @@ std::vector<std::vector<Color>> buffers;
         for (size_t scanline = 0; scanline < buffer.size() / imageWidth; ++scanline)
         {
             const size_t srcOffset = scanline * imageWidth;
-            const size_t copySize = imageWidth * sizeof(hvk::Color);
+            const size_t copySize = imageWidth * sizeof(hvk::Float3);
             const size_t destScanlineOffset = scanline * width;
             const size_t destOffset = viewportRowOffset + viewportColumnOffset + destScanlineOffset;
             memcpy(
-                reinterpret_cast<hvk::Color*>(finalBuffer.data()) + destOffset,
-                reinterpret_cast<const hvk::Color*>(buffer.data()) + srcOffset,
+                finalBuffer.data() + destOffset,
+                buffer.data() + srcOffset,
                 copySize);
         }
 
@@ -263,172 +356,646 @@ std::vector<std::vector<Color>> buffers;
         }
     }
 
-    for (const auto& c : finalBuffer)
+    hvk::WriteImage(std::cout, finalBuffer, width, height);
+}
+
+// Adds up the samples of the checkpoints named on the command line, which must
+// all be of one image, and writes out the image they resolve to
+int mergeCheckpoints(int argc, char** argv)
+{
+    if (argc < 3)
     {
-        writeColor(c);
+        std::cerr << "usage: " << argv[0] << " merge CHECKPOINT... > image.ppm" << std::endl;
+        return 1;
     }
+
+    std::optional<hvk::AccumulationBuffer> merged;
+    // merged lives in memory, so it remembers the image of the first
+    uint64_t imageHash = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        const auto shard = hvk::AccumulationBuffer::OpenCheckpoint(argv[i]);
+        if (!shard.has_value())
+        {
+            std::cerr << "Cannot read checkpoint " << argv[i] << std::endl;
+            return 1;
+        }
+        if (!merged.has_value())
+        {
+            merged.emplace(shard->getWidth(), shard->getHeight());
+            imageHash = shard->getImageHash();
+        }
+        else if (shard->getWidth() != merged->getWidth() || shard->getHeight() != merged->getHeight())
+        {
+            std::cerr << argv[i] << " is " << shard->getWidth() << "x" << shard->getHeight() << ", not "
+                      << merged->getWidth() << "x" << merged->getHeight() << std::endl;
+            return 1;
+        }
+        else if (shard->getImageHash() != imageHash)
+        {
+            std::cerr << argv[i] << " is of another scene or view than " << argv[2] << std::endl;
+            return 1;
+        }
+        merged->Merge(shard.value());
+    }
+
+    const size_t numPixels = merged->getWidth() * merged->getHeight();
+    std::vector<hvk::Float3> colors(numPixels);
+    for (size_t pixel = 0; pixel < numPixels; ++pixel)
+    {
+        colors[pixel] = merged->Resolve(pixel);
+    }
+    const auto minSamples = merged->getMinSampleCount(0, numPixels);
+    std::cerr << "Merged " << (argc - 2) << " checkpoints, at least " << minSamples << " samples per pixel" << std::endl;
+    if (minSamples == 0)
+    {
+        std::cerr << "Some pixels have no samples, is a shard missing?" << std::endl;
+    }
+    hvk::WriteImage(std::cout, colors, merged->getWidth(), merged->getHeight());
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "merge") == 0)
+    {
+        return mergeCheckpoints(argc, argv);
+    }
+
+    hvk::RenderOptions defaults = {};
+    defaults.numSamples = kNumSamples;
+    defaults.progressive = false;
+    defaults.costHeatmap = false;
+    defaults.denoise = false;
+    defaults.beautyOnly = false;
+    defaults.sceneName = "demo";
+    defaults.passSamples = kPassSamples;
+    defaults.seed = 0;
+    defaults.shardIndex = 0;
+    defaults.shardCount = 1;
+    defaults.shardMode = hvk::ShardMode::Rows;
+    const auto parsedOptions = hvk::ParseOptions(argc, argv, defaults);
+    if (!parsedOptions.has_value())
+    {
+        return 1;
+    }
+    const hvk::RenderOptions& options = parsedOptions.value();
     entt::registry registry;
 
     // Image setup
     const auto aspectRatio = 16.f / 9.f;
     const uint16_t imageWidth = 600;
     const uint16_t imageHeight = static_cast<uint16_t>(imageWidth / aspectRatio);
-    std::vector<Color> writeOutBuffer;
+    std::vector<hvk::Float3> writeOutBuffer;
     writeOutBuffer.resize(imageHeight * imageWidth);
-    std::vector<Color> normalBuffer;
-    normalBuffer.resize(imageHeight * imageWidth);
-    std::vector<Color> reflectBuffer;
-    reflectBuffer.resize(imageHeight * imageWidth);
-    std::vector<double> depthBuffer;
-    depthBuffer.resize(imageHeight * imageWidth);
-    std::vector<Color> hitBuffer;
-    hitBuffer.resize(imageHeight * imageWidth);
-
-    // Camera setup
-    const hvk::Camera camera(
-            hvk::Vector(-1.5f, .6f, 0.8f),
-            hvk::Vector(0.f, 0.f, -1.f),
-            hvk::Vector(0.f, 1.f, 0.f),
-            60.f,
-            aspectRatio,
-            0.001f,
-            2.f);
-
-    // World / Scene
-    auto sphereEntity = registry.create();
-    registry.emplace<hvk::Sphere>(sphereEntity, hvk::Vector(0.0f, 0.0f, -1.f), 0.5f);
-    registry.emplace<hvk::Material>(sphereEntity, hvk::MaterialType::Diffuse, hvk::Color(1.f, 0.f, 0.f), -1.f);
-
-//    auto groundEntity = registry.create();
-//    registry.emplace<hvk::Sphere>(groundEntity, hvk::Vector(0, -100.5f, -1.f), 100.f);
-//    registry.emplace<hvk::Material>(groundEntity, hvk::MaterialType::Diffuse, hvk::Color(0.f, 1.f, 0.f), -1.f);
-
-//    auto metalSphere1 = registry.create();
-//    registry.emplace<hvk::Sphere>(metalSphere1, hvk::Vector(-1.0f, 0.f, -1.f), 0.5f);
-//    registry.emplace<hvk::Material>(metalSphere1, hvk::MaterialType::Metal, hvk::Color(1.f, 1.f, 1.f));
-
-    auto metalSphere2 = registry.create();
-    registry.emplace<hvk::Sphere>(metalSphere2, hvk::Vector(1.0f, 0.f, -1.f), 0.5f);
-    registry.emplace<hvk::Material>(metalSphere2, hvk::MaterialType::Metal, hvk::Color(1.f, 1.f, 1.f), -1.f);
-
-    auto behindSphere = registry.create();
-    registry.emplace<hvk::Sphere>(behindSphere, hvk::Vector(0.5f, 0.0f, 1.f), 0.5f);
-    registry.emplace<hvk::Material>(behindSphere, hvk::MaterialType::Diffuse, hvk::Color(1.f, 0.f, 1.f), -1.f);
-
-    auto glassSphere = registry.create();
-    registry.emplace<hvk::Sphere>(glassSphere, hvk::Vector(2.f, 0.f, -1.f), 0.5f);
-    registry.emplace<hvk::Material>(glassSphere, hvk::MaterialType::Dielectric, hvk::Color(0.8f, 0.8f, 0.8f), 1.5);
-
-    auto smallGlass = registry.create();
-    registry.emplace<hvk::Sphere>(smallGlass, hvk::Vector(0.3f, -.3f, -0.4f), 0.2f);
-    registry.emplace<hvk::Material>(smallGlass, hvk::MaterialType::Dielectric, hvk::Color(1.f, 1.f, 1.f), 1.5);
-
-    auto smallGlass2 = registry.create();
-    registry.emplace<hvk::Sphere>(smallGlass2, hvk::Vector(-0.32f, -.3f, -0.42f), 0.2f);
-    registry.emplace<hvk::Material>(smallGlass2, hvk::MaterialType::Dielectric, hvk::Color(1.f, 1.f, 1.f), 1.5);
-
-    auto smallMetalSphere = registry.create();
-    registry.emplace<hvk::Sphere>(smallMetalSphere, hvk::Vector(-0.68f, -.3f, -0.69f), 0.25f);
-    registry.emplace<hvk::Material>(smallMetalSphere, hvk::MaterialType::Metal, hvk::Color(0.7f, 0.2f, 0.7f), -1.f);
-
-    auto groundPlane = registry.create();
-    registry.emplace<hvk::Plane>(groundPlane, hvk::Vector(0.f, -0.5f, 0.f), hvk::Vector(0.f, 1.f, 0.f));
-    registry.emplace<hvk::Material>(groundPlane, hvk::MaterialType::Diffuse, hvk::Color(0.8f, 0.8f, 0.8f), -1.f);
-
-    auto smallMetalBox = registry.create();
-    registry.emplace<hvk::Box>(
-            smallMetalBox,
-            hvk::Plane(hvk::Vector(0.f, 0.5f, -4.f), hvk::Vector(0.f, 1.f, 0.f)), // top
-            hvk::Plane(hvk::Vector(0.f, -0.5f, -4.f), hvk::Vector(0.f, -1.f, 0.f)), // bottom
-            hvk::Plane(hvk::Vector(0.f, 0.f, -3.5f), hvk::Vector(0.f, 0.f, 1.f)), // front
-            hvk::Plane(hvk::Vector(0.f, 0.f, -4.5f), hvk::Vector(0.f, 0.f, -1.f)), // back
-            hvk::Plane(hvk::Vector(-0.5f, 0.f, -4.f), hvk::Vector(-1.f, 0.f, 0.f)), // left
-            hvk::Plane(hvk::Vector(0.5f, 0.f, -4.f), hvk::Vector(1.f, 0.f, 0.f))); // right
-    registry.emplace<hvk::Material>(smallMetalBox, hvk::MaterialType::Metal, hvk::Color(0.8f, 0.6f, 0.1f), -1.f);
-
-    auto glassBox = registry.create();
-    registry.emplace<hvk::Box>(
-            glassBox,
-            hvk::Plane(hvk::Vector(-0.5f, 0.0f, -2.5f), hvk::Vector(0.f, 1.f, 0.f)), // top
-            hvk::Plane(hvk::Vector(-0.5f, -0.5f, -2.5f), hvk::Vector(0.f, -1.f, 0.f)), // bottom
-            hvk::Plane(hvk::Vector(-0.5f, -0.25f, -2.f), hvk::Vector(0.f, 0.f, 1.f)), // front
-            hvk::Plane(hvk::Vector(-0.5f, -0.25f, -2.5f), hvk::Vector(0.f, 0.f, -1.f)), // back
-            hvk::Plane(hvk::Vector(-1.f, -0.25f, -2.5f), hvk::Vector(-1.f, 0.f, 0.f)), // left
-            hvk::Plane(hvk::Vector(-0.5f, -0.25f, -2.5f), hvk::Vector(1.f, 0.f, 0.f))); // right
-    registry.emplace<hvk::Material>(glassBox, hvk::MaterialType::Dielectric, hvk::Color(.9f, .9f, .9f), 1.5f);
-
-//    auto diffuseBox = registry.create();
-//    registry.emplace<hvk::Box>(
-//            diffuseBox,
-//            hvk::Plane(hvk::Vector(-1.5f, 1.f, -2.f), hvk::Vector(0.f, 1.f, 0.f)),
-//            hvk::Plane(hvk::Vector(-1.5f, -0.5f, -2.f), hvk::Vector(0.f, -1.f, 0.f)),
-//            hvk::Plane(hvk::Vector(-1.5f, 0.25f, -1.f), hvk::Vector(0.f, 0.f, 1.f)),
-//            hvk::Plane(hvk::Vector(-1.5f, 0.25f, -3.f), hvk::Vector(0.f, 0.f, -1.f)),
-//            hvk::Plane(hvk::Vector(-2.5f, 0.25f, -2.f), hvk::Vector(-1.f, 0.f, 0.f)),
-//            hvk::Plane(hvk::Vector(-1.f, 0.25f, -2.f), hvk::Vector(1.f, 0.f, 0.f)));
-//    registry.emplace<hvk::Material>(diffuseBox, hvk::MaterialType::Diffuse, hvk::Color(0.66, 0.2, 0.8));
-
-    // auto metalBox = registry.create();
-    // registry.emplace<hvk::Box>(
-    //         metalBox,
-    //         hvk::Plane(hvk::Vector(-1.5f, 1.f, -2.f), hvk::Vector(0.f, 1.f, 0.f)),
-    //         hvk::Plane(hvk::Vector(-1.5f, -0.5f, -2.f), hvk::Vector(0.f, -1.f, 0.f)),
-    //         hvk::Plane(hvk::Vector(-1.5f, 0.25f, 0.f), hvk::Vector(0.f, 0.f, 1.f)),
-    //         hvk::Plane(hvk::Vector(-1.5f, 0.25f, -3.f), hvk::Vector(0.f, 0.f, -1.f)),
-    //         hvk::Plane(hvk::Vector(-2.5f, 0.25f, -2.f), hvk::Vector(-1.f, 0.f, 0.f)),
-    //         hvk::Plane(hvk::Vector(-1.f, 0.25f, -2.f), hvk::Vector(1.f, 0.f, 0.f)));
-    // registry.emplace<hvk::Material>(metalBox, hvk::MaterialType::Metal, hvk::Color(.8f, .8f, .8f), -1.f);
+    // milliseconds of worker time spent on each pixel, over all passes
+    std::vector<float> pixelCosts(imageHeight * imageWidth, 0.f);
+    // opened once the scene says which image this is
+    std::optional<hvk::AccumulationBuffer> accumulation;
+
+    // the pixels and the samples per pixel this process renders
+    PixelRect shardRect = { 0, imageWidth, 0, imageHeight };
+    uint32_t numSamples = options.numSamples;
+    if (options.shardCount > 1)
+    {
+        if (options.shardMode == hvk::ShardMode::Rows)
+        {
+            // whole rows of tiles, so that shards never split one
+            const uint32_t numTileRows = (imageHeight + kTileSize - 1) / kTileSize;
+            const auto shardRow = [&](uint32_t shard)
+            {
+                return static_cast<uint16_t>(std::min<uint32_t>(imageHeight, numTileRows * shard / options.shardCount * kTileSize));
+            };
+            shardRect.rowBegin = shardRow(options.shardIndex);
+            shardRect.rowEnd = shardRow(options.shardIndex + 1);
+        }
+        else
+        {
+            numSamples = options.numSamples * (options.shardIndex + 1) / options.shardCount -
+                options.numSamples * options.shardIndex / options.shardCount;
+        }
+        std::cerr << "Shard " << options.shardIndex << "/" << options.shardCount << ": rows " << shardRect.rowBegin << " to "
+                  << shardRect.rowEnd << ", " << numSamples << " samples per pixel" << std::endl;
+    }
+    hvk::GBuffer gbuffer(imageWidth, imageHeight);
+
+    // Camera and world
+    const auto canonical = std::find_if(hvk::scenes::kCanonical.begin(), hvk::scenes::kCanonical.end(), [&](const auto& scene)
+    {
+        return options.sceneName == scene.name;
+    });
+    if (canonical == hvk::scenes::kCanonical.end())
+    {
+        std::cerr << "Unknown scene " << options.sceneName << std::endl;
+        return 1;
+    }
+    const hvk::Camera camera = canonical->build(registry, aspectRatio);
 
     {
         // Create thread pool
         hvk::ThreadPool pool(kNumThreads);
 
+        // Build acceleration structures
+        const auto buildStart = std::chrono::steady_clock::now();
+        hvk::Scene scene(registry);
+        scene.Build(&pool, kBuildQuality);
+        const auto buildEnd = std::chrono::steady_clock::now();
+        std::cerr << "BVH build: "
+                  << std::chrono::duration<double, std::milli>(buildEnd - buildStart).count() << " ms" << std::endl;
+
+        // what a coordinator and its workers, or a checkpoint and the render
+        // resuming it, must agree on: the scene, the image size and the rays
+        // the camera shoots through the corners
+        uint64_t imageHash = scene.getHash();
+        imageHash = hvk::hash::Combine(imageHash, static_cast<uint32_t>(imageWidth));
+        imageHash = hvk::hash::Combine(imageHash, static_cast<uint32_t>(imageHeight));
+        for (const auto corner : { 0.f, 1.f })
+        {
+            const auto ray = camera.GetRay(corner, corner);
+            imageHash = hvk::hash::Combine(imageHash, ray.getOrigin());
+            imageHash = hvk::hash::Combine(imageHash, ray.getDirection());
+        }
+
+        if (options.checkpointPath.has_value())
+        {
+            accumulation = hvk::AccumulationBuffer::OpenCheckpoint(options.checkpointPath.value(), imageWidth, imageHeight, imageHash);
+            if (!accumulation.has_value())
+            {
+                std::cerr << "Cannot use " << options.checkpointPath.value() << " as a checkpoint for this "
+                          << imageWidth << "x" << imageHeight << " image" << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            accumulation.emplace(imageWidth, imageHeight);
+        }
+
+        // Every shard and every worker draws its own samples, and so does
+        // every run resuming a checkpoint. Nothing has drawn a number yet.
+        const uint32_t seed = accumulation->getRun() == 0 ? options.seed :
+            static_cast<uint32_t>(hvk::hash::Combine(options.seed, accumulation->getRun()));
+        hvk::math::setRandomSeed(seed, options.workerHost.has_value() ? std::random_device()() : options.shardIndex);
+
+        // first hit attributes, which don't depend on the pass
+        bool haveGBuffer = false;
+        const auto renderGBuffer = [&]()
+        {
+            const auto gbufferStart = std::chrono::steady_clock::now();
+            gbuffer.Render(scene, camera, kGBufferSamples, pool);
+            haveGBuffer = true;
+            std::cerr << "G-buffer: "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - gbufferStart).count()
+                      << " ms" << std::endl;
+        };
+        const auto denoise = [&]()
+        {
+            hvk::Denoiser denoiser(imageWidth, imageHeight, kDenoiseIterations);
+            denoiser.Denoise(gbuffer, writeOutBuffer, pool);
+        };
+        // every published pass is denoised as well, so those need it up front
+        if (options.denoise && options.progressPath.has_value())
+        {
+            renderGBuffer();
+            // its rays aren't the render's
+            hvk::stats::Reset();
+        }
+        const auto renderStart = std::chrono::steady_clock::now();
+
         // Render
-        for (int i = imageHeight - 1; i >= 0; --i)
+        std::atomic<uint64_t> nodeFetches = 0;
+        std::atomic<uint64_t> nodeMisses = 0;
+        const auto accumulateNodeCache = [&](const hvk::NodeCacheSimulator& cache, uint64_t fetchesBefore, uint64_t missesBefore)
+        {
+            hvk::NodeCacheSimulator::Current() = nullptr;
+            nodeFetches += cache.getAccesses() - fetchesBefore;
+            nodeMisses += cache.getMisses() - missesBefore;
+        };
+
+        // only progressive renders, coordinators and workers can stop early,
+        // other runs die on SIGINT as before
+        if (options.progressive || options.servePort.has_value() || options.workerHost.has_value())
+        {
+            std::signal(SIGINT, onInterrupt);
+        }
+        const hvk::RenderBudget budget(
+            options.timeBudgetMs.has_value() ?
+                std::make_optional<hvk::RenderBudget::Clock::duration>(std::chrono::milliseconds(options.timeBudgetMs.value())) :
+                std::nullopt,
+            gCancelRequested);
+
+        const auto addSamples = [&](size_t writeIndex, const Color& sum, uint32_t numSamples)
+        {
+            accumulation->Add(writeIndex, sum, numSamples);
+        };
+        // each pixel is written by one task per pass, and passes don't overlap
+        const auto addCost = [&](size_t writeIndex, float milliseconds)
+        {
+            pixelCosts[writeIndex] += milliseconds;
+        };
+        const auto millisecondsSince = [](std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+        const auto resolve = [&]()
+        {
+            for (size_t pixel = 0; pixel < writeOutBuffer.size(); ++pixel)
+            {
+                writeOutBuffer[pixel] = accumulation->Resolve(pixel);
+            }
+        };
+        const auto getMinSampleCount = [&](const PixelRect& rect)
+        {
+            uint32_t minSamples = UINT32_MAX;
+            for (uint16_t row = rect.rowBegin; row < rect.rowEnd; ++row)
+            {
+                const size_t rowStart = row * imageWidth;
+                minSamples = std::min(minSamples,
+                    accumulation->getMinSampleCount(rowStart + rect.columnBegin, rowStart + rect.columnEnd));
+            }
+            return minSamples == UINT32_MAX ? 0 : minSamples;
+        };
+
+        // Brings every pixel of rect up to numSamples samples, in passes when
+        // progressive, and returns how many samples every pixel of it has. Every
+        // pass but the first gives up on tasks it has not started once the
+        // budget is exhausted, leaving their pixels with fewer samples.
+        uint32_t numPasses = 0;
+        const auto renderRect = [&](const PixelRect& rect, uint32_t numSamples)
+        {
+            uint32_t samplesDone = getMinSampleCount(rect);
+            uint16_t passSamples = 0;
+            // a cancelled worker's tile is dropped anyway, so it may stop right away
+            const auto skipTask = [&]()
+            {
+                return (samplesDone > 0 && budget.IsExhausted()) || (options.workerHost.has_value() && gCancelRequested);
+            };
+            while (samplesDone < numSamples && !skipTask())
+            {
+                RTX_WEEKEND_TRACE_SCOPE("Pass");
+                const uint16_t remainingSamples = static_cast<uint16_t>(numSamples - samplesDone);
+                passSamples = options.progressive ? std::min(options.passSamples, remainingSamples) : remainingSamples;
+
+                if (kKernel == Kernel::Wavefront)
+                {
+                    for (uint16_t tileY = rect.rowBegin; tileY < rect.rowEnd; tileY += kTileSize)
+                    {
+                        for (uint16_t tileX = rect.columnBegin; tileX < rect.columnEnd; tileX += kTileSize)
+                        {
+                            pool.QueueWork([&, tileX, tileY]()
+                            {
+                                if (skipTask())
+                                {
+                                    return;
+                                }
+                                RTX_WEEKEND_TRACE_SCOPE("Tile", tileX, tileY);
+                                const auto tileStart = std::chrono::steady_clock::now();
+
+                                // one cache per worker, warm across the tasks it runs
+                                thread_local hvk::NodeCacheSimulator cache;
+                                const auto fetchesBefore = cache.getAccesses();
+                                const auto missesBefore = cache.getMisses();
+                                hvk::NodeCacheSimulator::Current() = kSimulateNodeCache ? &cache : nullptr;
+
+                                const uint16_t tileWidth = std::min<uint16_t>(kTileSize, rect.columnEnd - tileX);
+                                const uint16_t tileHeight = std::min<uint16_t>(kTileSize, rect.rowEnd - tileY);
+                                const size_t numPixels = tileWidth * tileHeight;
+                                std::vector<Color> pixelColors(numPixels, Color(0.f, 0.f, 0.f));
+
+                                hvk::WavefrontIntegrator integrator(scene, kReorderRays);
+                                std::vector<hvk::Ray> primaryRays;
+                                std::vector<Color> colors;
+                                for (size_t s = 0; s < passSamples; s += kWavefrontSamples)
+                                {
+                                    const size_t numSamples = std::min<size_t>(kWavefrontSamples, passSamples - s);
+                                    primaryRays.clear();
+                                    for (size_t pixel = 0; pixel < numPixels; ++pixel)
+                                    {
+                                        // rows are stored top down, i counts scanlines from the bottom
+                                        const int i = (imageHeight - 1) - (tileY + static_cast<int>(pixel / tileWidth));
+                                        const int j = tileX + static_cast<int>(pixel % tileWidth);
+                                        for (size_t sample = 0; sample < numSamples; ++sample)
+                                        {
+                                            auto u = static_cast<hvk::Real>(j + hvk::math::getRandom<hvk::Real, hvk::Real(0), hvk::Real(1)>()) /
+                                                     (imageWidth - 1);
+                                            auto v = static_cast<hvk::Real>(i + hvk::math::getRandom<hvk::Real, hvk::Real(0), hvk::Real(1)>()) /
+                                                     (imageHeight - 1);
+                                            primaryRays.push_back(camera.GetRay(u, v));
+                                        }
+                                    }
+
+                                    integrator.Trace(primaryRays, colors);
+                                    for (size_t ray = 0; ray < colors.size(); ++ray)
+                                    {
+                                        pixelColors[ray / numSamples] += colors[ray];
+                                    }
+                                }
+
+                                // the pixels of a tile are traced together, so they share its cost
+                                const float pixelCost = millisecondsSince(tileStart) / numPixels;
+                                for (size_t pixel = 0; pixel < numPixels; ++pixel)
+                                {
+                                    const size_t writeIndex = (tileY + pixel / tileWidth) * imageWidth + tileX + pixel % tileWidth;
+                                    addSamples(writeIndex, pixelColors[pixel], passSamples);
+                                    addCost(writeIndex, pixelCost);
+                                }
+                                accumulateNodeCache(cache, fetchesBefore, missesBefore);
+                            });
+                        }
+                    }
+                }
+#if defined(__AVX2__)
+                else if (kKernel == Kernel::SPMD)
+                {
+                    for (uint16_t tileY = rect.rowBegin; tileY < rect.rowEnd; tileY += kTileSize)
+                    {
+                        for (uint16_t tileX = rect.columnBegin; tileX < rect.columnEnd; tileX += kTileSize)
+                        {
+                            pool.QueueWork([&, tileX, tileY]()
+                            {
+                                if (skipTask())
+                                {
+                                    return;
+                                }
+                                RTX_WEEKEND_TRACE_SCOPE("Tile", tileX, tileY);
+
+                                // one cache per worker, warm across the tasks it runs
+                                thread_local hvk::NodeCacheSimulator cache;
+                                const auto fetchesBefore = cache.getAccesses();
+                                const auto missesBefore = cache.getMisses();
+                                hvk::NodeCacheSimulator::Current() = kSimulateNodeCache ? &cache : nullptr;
+
+                                constexpr size_t kLanes = hvk::SPMDIntegrator::kWidth;
+                                hvk::SPMDIntegrator integrator(scene);
+                                const uint16_t tileEndX = std::min<uint16_t>(tileX + kTileSize, rect.columnEnd);
+                                const uint16_t tileEndY = std::min<uint16_t>(tileY + kTileSize, rect.rowEnd);
+                                for (uint16_t row = tileY; row < tileEndY; ++row)
+                                {
+                                    // each lane follows a different pixel of the row
+                                    for (uint16_t column = tileX; column < tileEndX; column += kLanes)
+                                    {
+                                        const auto lanesStart = std::chrono::steady_clock::now();
+                                        const size_t numLanes = std::min<size_t>(kLanes, tileEndX - column);
+                                        const int i = (imageHeight - 1) - row;
+                                        std::array<Color, kLanes> pixelColors;
+                                        pixelColors.fill(Color(0.f, 0.f, 0.f));
+                                        std::array<Color, kLanes> colors;
+                                        for (size_t s = 0; s < passSamples; ++s)
+                                        {
+                                            hvk::RayPacket<kLanes> packet;
+                                            for (size_t lane = 0; lane < numLanes; ++lane)
+                                            {
+                                                const int j = column + static_cast<int>(lane);
+                                                auto u = static_cast<hvk::Real>(j + hvk::math::getRandom<hvk::Real, hvk::Real(0), hvk::Real(1)>()) /
+                                                         (imageWidth - 1);
+                                                auto v = static_cast<hvk::Real>(i + hvk::math::getRandom<hvk::Real, hvk::Real(0), hvk::Real(1)>()) /
+                                                         (imageHeight - 1);
+                                                packet.Set(lane, camera.GetRay(u, v));
+                                            }
+
+                                            integrator.Trace(packet, colors);
+                                            for (size_t lane = 0; lane < numLanes; ++lane)
+                                            {
+                                                pixelColors[lane] += colors[lane];
+                                            }
+                                        }
+
+                                        // the lanes are traced together, so they share the cost
+                                        const float laneCost = millisecondsSince(lanesStart) / numLanes;
+                                        for (size_t lane = 0; lane < numLanes; ++lane)
+                                        {
+                                            const size_t writeIndex = row * imageWidth + column + lane;
+                                            addSamples(writeIndex, pixelColors[lane], passSamples);
+                                            addCost(writeIndex, laneCost);
+                                        }
+                                    }
+                                }
+                                accumulateNodeCache(cache, fetchesBefore, missesBefore);
+                            });
+                        }
+                    }
+                }
+#endif
+                else
+                {
+                    // one task per scanline of rect, so that the queue and the
+                    // trace hold one entry per row rather than per pixel
+                    for (int i = (imageHeight - 1) - rect.rowBegin; i >= imageHeight - rect.rowEnd; --i)
+                    {
+                        pool.QueueWork([&, i]()
+                        {
+                            if (skipTask())
+                            {
+                                return;
+                            }
+                            const uint16_t row = static_cast<uint16_t>((imageHeight - 1) - i);
+                            RTX_WEEKEND_TRACE_SCOPE("Row", rect.columnBegin, row);
+
+                            // one cache per worker, warm across the tasks it runs
+                            thread_local hvk::NodeCacheSimulator cache;
+                            const auto fetchesBefore = cache.getAccesses();
+                            const auto missesBefore = cache.getMisses();
+                            hvk::NodeCacheSimulator::Current() = kSimulateNodeCache ? &cache : nullptr;
+                            for (int j = rect.columnBegin; j < rect.columnEnd; ++j)
+                            {
+                                const auto pixelStart = std::chrono::steady_clock::now();
+                                const Color pixelColor = hvk::SamplePixel(scene, camera, i, j, imageWidth, imageHeight, passSamples);
+                                const size_t writeIndex = row * imageWidth + j;
+                                addSamples(writeIndex, pixelColor, passSamples);
+                                addCost(writeIndex, millisecondsSince(pixelStart));
+                            }
+                            accumulateNodeCache(cache, fetchesBefore, missesBefore);
+                        });
+                    }
+                }
+                pool.Wait();
+                samplesDone += passSamples;
+                ++numPasses;
+
+                if (!accumulation->Sync())
+                {
+                    std::cerr << "Failed to sync the checkpoint" << std::endl;
+                }
+                if (options.progressPath.has_value())
+                {
+                    resolve();
+                    if (options.denoise)
+                    {
+                        denoise();
+                    }
+                    publishImage(options.progressPath.value(), writeOutBuffer, imageWidth, imageHeight);
+                }
+            }
+            return samplesDone;
+        };
+
+        uint32_t samplesDone = 0;
+        if (options.workerHost.has_value())
+        {
+            // the coordinator only takes tiles from workers that agree on the image
+            hvk::TileWorker worker(imageHash, [&](const hvk::TileJob& job, std::vector<hvk::TileSample>& samples)
+            {
+                const PixelRect rect = { job.x, static_cast<uint16_t>(job.x + job.width), job.y, static_cast<uint16_t>(job.y + job.height) };
+                for (uint16_t row = rect.rowBegin; row < rect.rowEnd; ++row)
+                {
+                    for (uint16_t column = rect.columnBegin; column < rect.columnEnd; ++column)
+                    {
+                        accumulation->Reset(row * imageWidth + column);
+                    }
+                }
+                renderRect(rect, job.sampleCount);
+                for (uint16_t row = 0; row < job.height; ++row)
+                {
+                    for (uint16_t column = 0; column < job.width; ++column)
+                    {
+                        const size_t pixel = (job.y + row) * imageWidth + job.x + column;
+                        samples[row * job.width + column] = { accumulation->getSum(pixel), accumulation->getSampleCount(pixel) };
+                    }
+                }
+            });
+            const bool finished = worker.Run(options.workerHost.value(), options.workerPort, gCancelRequested);
+            std::cerr << "Rendered " << worker.getNumTilesRendered() << " tiles for "
+                      << options.workerHost.value() << ":" << options.workerPort << std::endl;
+            if (gCancelRequested)
+            {
+                std::cerr << "Interrupted, the coordinator re-issues the tile in hand" << std::endl;
+                return 1;
+            }
+            if (!finished)
+            {
+                std::cerr << "Lost the coordinator, or it refused this worker" << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+        else if (options.servePort.has_value())
         {
-            for (int j = 0; j < imageWidth; ++j)
+            // every tile still short of numSamples, which is all of them unless resuming
+            std::vector<hvk::TileJob> jobs;
+            for (uint16_t y = 0; y < imageHeight; y += kServerTileSize)
             {
-                pool.QueueWork([&, i, j]()
-               {
-                   Color pixelColor(0.f, 0.f, 0.f);
-                   auto result = std::make_optional(RayTestResult{});
-                   for (size_t s = 0; s < kNumSamples; ++s)
-                   {
-                       auto u = static_cast<double>(j + hvk::math::getRandom<double, 0.0, 1.0>()) /
-                                (imageWidth - 1);
-                       auto v = static_cast<double>(i + hvk::math::getRandom<double, 0.0, 1.0>()) /
-                                (imageHeight - 1);
-
-                       hvk::Ray skyRay = camera.GetRay(u, v);
-                       pixelColor += rayColor(skyRay, registry, kMaxRayDepth, result);
-                   }
-                   const size_t writeIndex = ((imageHeight - 1) - i) * imageWidth + j;
-                   // const hvk::Color normalizedHit = 0.5f * hvk::Color(
-                   //         result->hit.X() / viewportWidth + 1,
-                   //         result->hit.Y() / viewportHeight + 1,
-                   //         -result->hit.Z() / 1.5f);
-                   writeOutBuffer[writeIndex] = (pixelColor / kNumSamples);
-                   depthBuffer[writeIndex] = (result->depth / kNumSamples);
-                   normalBuffer[writeIndex] = (result->normal / kNumSamples);
-                   reflectBuffer[writeIndex] = (result->reflect / kNumSamples);
-                   // hitBuffer[writeIndex] = (normalizedHit / kNumSamples);
-               });
+                for (uint16_t x = 0; x < imageWidth; x += kServerTileSize)
+                {
+                    const PixelRect rect = {
+                        x, std::min<uint16_t>(imageWidth, x + kServerTileSize),
+                        y, std::min<uint16_t>(imageHeight, y + kServerTileSize) };
+                    const uint32_t tileSamples = getMinSampleCount(rect);
+                    if (tileSamples < numSamples)
+                    {
+                        jobs.push_back({
+                            0, x, y,
+                            static_cast<uint16_t>(rect.columnEnd - x),
+                            static_cast<uint16_t>(rect.rowEnd - y),
+                            numSamples - tileSamples });
+                    }
+                }
             }
+
+            hvk::TileCoordinator coordinator(imageHash, std::move(jobs), [&](const hvk::TileJob& job, const std::vector<hvk::TileSample>& samples)
+            {
+                for (uint16_t row = 0; row < job.height; ++row)
+                {
+                    for (uint16_t column = 0; column < job.width; ++column)
+                    {
+                        const auto& sample = samples[row * job.width + column];
+                        accumulation->Add((job.y + row) * imageWidth + job.x + column, sample.sum.Load(), sample.count);
+                    }
+                }
+                accumulation->Sync();
+            });
+            if (!coordinator.Run(options.servePort.value(), gCancelRequested))
+            {
+                std::cerr << "Cannot listen on port " << options.servePort.value() << std::endl;
+                return 1;
+            }
+            samplesDone = getMinSampleCount(shardRect);
         }
+        else
+        {
+            if (const auto resumedSamples = getMinSampleCount(shardRect); resumedSamples > 0)
+            {
+                std::cerr << "Resuming from " << resumedSamples << " samples per pixel" << std::endl;
+            }
+            samplesDone = renderRect(shardRect, numSamples);
+        }
+        resolve();
+        const auto renderEnd = std::chrono::steady_clock::now();
+        std::cerr << "Render: "
+                  << std::chrono::duration<double, std::milli>(renderEnd - renderStart).count() << " ms, ";
+        if (options.servePort.has_value())
+        {
+            std::cerr << "by workers";
+        }
+        else
+        {
+            std::cerr << numPasses << (numPasses == 1 ? " pass" : " passes");
+        }
+        std::cerr << ", up to " << samplesDone << " samples per pixel"
+                  << (samplesDone < numSamples ? " (stopped early)" : "") << std::endl;
+        // a coordinator traces no rays of its own
+        if (hvk::stats::kEnabled && !options.servePort.has_value())
+        {
+            reportRayStats(
+                hvk::stats::Collect(),
+                hvk::stats::CollectPaths(),
+                std::chrono::duration<double>(renderEnd - renderStart).count(),
+                options.statsPath);
+        }
+        if (kSimulateNodeCache)
+        {
+            std::cerr << "BVH node fetches: " << nodeFetches << ", simulated cache misses: " << nodeMisses
+                      << " (" << (nodeFetches > 0 ? 100.0 * nodeMisses / nodeFetches : 0.0) << "%)" << std::endl;
+        }
+
+        // the image only exists once the shards are merged
+        if (options.shardCount > 1)
+        {
+            return 0;
+        }
+
+        // only the denoiser needs it when the mosaic is not written
+        if (!haveGBuffer && (!options.beautyOnly || options.denoise))
+        {
+            renderGBuffer();
+        }
+
+        if (options.denoise)
+        {
+            const auto denoiseStart = std::chrono::steady_clock::now();
+            denoise();
+            const auto denoiseEnd = std::chrono::steady_clock::now();
+            std::cerr << "Denoise: "
+                      << std::chrono::duration<double, std::milli>(denoiseEnd - denoiseStart).count() << " ms" << std::endl;
+        }
+    }
+
+    if (options.beautyOnly)
+    {
+        writeBuffers(writeOutBuffer, imageWidth, imageHeight, std::nullopt, std::nullopt, std::nullopt, std::nullopt);
+    }
+    else
+    {
+        writeBuffers(
+            writeOutBuffer,
+            imageWidth,
+            imageHeight,
+            std::make_optional(gbuffer.getDepth()),
+            std::make_optional(gbuffer.getNormal()),
+            std::make_optional(gbuffer.getAlbedo()),
+            // a coordinator's pixels were rendered, and timed, by its workers
+            options.costHeatmap && !options.servePort.has_value() ? std::make_optional(pixelCosts) : std::nullopt);
     }
 
-    writeBuffers(
-        writeOutBuffer,
-        imageWidth,
-        imageHeight,
-        std::make_optional(depthBuffer),
-        std::make_optional(normalBuffer),
-        std::make_optional(reflectBuffer),
-        std::nullopt);
-        // std::make_optional(hitBuffer));
+    if (options.tracePath.has_value())
+    {
+        if (!hvk::trace::kEnabled)
+        {
+            std::cerr << "Tracing is not compiled in, configure with RTX_WEEKEND_TRACE=ON" << std::endl;
+        }
+        else if (!hvk::trace::Write(options.tracePath.value()))
+        {
+            std::cerr << "Failed to write " << options.tracePath.value() << std::endl;
+        }
+    }
 
     return 0;
 }
@@ -1,14 +1,37 @@
 #include "math.h"
 #include <cmath>
+#include <atomic>
 #include <DirectXMath.h>
 
 namespace hvk
 {
     namespace math
     {
-        double degreesToRadians(double degrees)
+        std::atomic<uint32_t> _seed = 0;
+        std::atomic<uint32_t> _stream = 0;
+        std::atomic<uint32_t> _nextThread = 0;
+
+        void setRandomSeed(uint32_t seed, uint32_t stream)
+        {
+            _seed = seed;
+            _stream = stream;
+        }
+
+        std::mt19937 makeGenerator()
+        {
+            std::seed_seq sequence{ _seed.load(), _stream.load(), _nextThread.fetch_add(1) };
+            return std::mt19937(sequence);
+        }
+
+        void seedThread(uint32_t seed, uint32_t stream)
+        {
+            std::seed_seq sequence{ seed, stream };
+            getGenerator().seed(sequence);
+        }
+
+        Real degreesToRadians(Real degrees)
         {
-            return degrees * DirectX::XM_PI / 180.f;
+            return degrees * static_cast<Real>(DirectX::XM_PI) / 180;
         }
     }
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #define _USE_MATH_DEFINES
 
+#include <algorithm>
 #include <random>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "Real.h"
 
 #ifndef RTX_WEEKEND_MATH_H
 #define RTX_WEEKEND_MATH_H
@@ -10,15 +15,41 @@ namespace hvk
 {
     namespace math
     {
+        // Seeds the generators of threads that have not drawn a number yet.
+        // Renders of one image with different streams draw uncorrelated
+        // samples, so that they can be merged.
+        void setRandomSeed(uint32_t seed, uint32_t stream);
+
+        // a generator seeded differently from every other thread's
+        std::mt19937 makeGenerator();
+
+        // Reseeds the calling thread's generator, for work that has to draw
+        // the same numbers whichever thread it runs on
+        void seedThread(uint32_t seed, uint32_t stream);
+
+        // one generator per thread, so that sampling threads never share state
+        inline std::mt19937& getGenerator()
+        {
+            thread_local std::mt19937 generator = makeGenerator();
+            return generator;
+        }
+
         template<typename T, T lower, T upper>
         T getRandom()
         {
-            static std::mt19937 generator;
-            static std::uniform_real_distribution<T> distribution(lower, upper);
-            return distribution(generator);
+            std::uniform_real_distribution<T> distribution(lower, upper);
+            return distribution(getGenerator());
         }
 
-        double degreesToRadians(double degrees);
+        Real degreesToRadians(Real degrees);
+
+        // 1 / x for slab tests, clamped to the largest finite floats so that
+        // an axis parallel ray starting on a slab's plane gets 0 * max = 0
+        // rather than 0 * inf = NaN, and is counted inside the slab
+        inline float slabInverse(float x)
+        {
+            return std::clamp(1.f / x, -std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        }
     }
 }
 
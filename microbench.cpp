@@ -0,0 +1,202 @@
+// rtx_microbench times the kernels a render spends its time in, one at a
+// time, over fixed sets of random inputs, and prints the nanoseconds per call
+// as JSON. A change to one of them can be measured here without the noise of
+// a whole render. Configured with -DRTX_WEEKEND_RAY_STATS=ON the
+// intersections also count their tests (see RayStats.h), which they are then
+// timed with.
+//
+//  rtx_microbench [--calls N] > results.json
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "Box.h"
+#include "Camera.h"
+#include "Plane.h"
+#include "Ray.h"
+#include "Sphere.h"
+#include "ThreadPool.h"
+#include "Vector.h"
+#include "hittest.h"
+#include "math.h"
+
+// calls per repetition, and repetitions of which the fastest is reported
+const size_t kDefaultCalls = 1 << 20;
+const size_t kRepetitions = 5;
+// inputs are cycled through, few enough to stay in cache
+const size_t kNumInputs = 1024;
+const uint32_t kSeed = 1;
+
+// Results are added into this so the compiler cannot drop the calls
+volatile float gSink = 0.f;
+
+// Nanoseconds per call of f(input) over numCalls calls cycling through inputs,
+// the fastest of kRepetitions so that preemption does not count
+template <typename Input, typename F>
+double measure(const std::vector<Input>& inputs, size_t numCalls, F&& f)
+{
+    double best = std::numeric_limits<double>::max();
+    for (size_t repetition = 0; repetition < kRepetitions; ++repetition)
+    {
+        float sink = 0.f;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t call = 0; call < numCalls; ++call)
+        {
+            sink += f(inputs[call % inputs.size()]);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        gSink = gSink + sink;
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / numCalls);
+    }
+    return best;
+}
+
+struct Inputs
+{
+    std::vector<hvk::Ray> rays;
+    std::vector<hvk::Vector> directions;
+    std::vector<hvk::Vector> normals;
+    std::vector<std::pair<float, float>> screenPoints;
+};
+
+Inputs makeInputs()
+{
+    std::mt19937 generator(kSeed);
+    std::uniform_real_distribution<float> random(-1.f, 1.f);
+    const auto randomUnit = [&]()
+    {
+        return hvk::Vector(random(generator), random(generator), random(generator)).Normalized();
+    };
+
+    // rays from around the origin towards the unit shapes at z = -2, most of which hit
+    Inputs inputs;
+    for (size_t i = 0; i < kNumInputs; ++i)
+    {
+        const hvk::Vector origin(0.1f * random(generator), 0.1f * random(generator), 0.1f * random(generator));
+        const hvk::Vector target(0.8f * random(generator), 0.8f * random(generator), -2.f);
+        inputs.rays.emplace_back(origin, target - origin);
+        inputs.directions.push_back(randomUnit());
+        inputs.normals.push_back(randomUnit());
+        inputs.screenPoints.emplace_back(0.5f + 0.5f * random(generator), 0.5f + 0.5f * random(generator));
+    }
+    return inputs;
+}
+
+int main(int argc, char** argv)
+{
+    size_t numCalls = kDefaultCalls;
+    if (argc == 3 && std::strcmp(argv[1], "--calls") == 0)
+    {
+        char* end = nullptr;
+        numCalls = std::strtoull(argv[2], &end, 10);
+        if (end == argv[2] || *end != '\0' || numCalls == 0)
+        {
+            argc = 0;
+        }
+    }
+    if (argc != 1 && argc != 3)
+    {
+        std::cerr << "usage: " << argv[0] << " [--calls N] > results.json" << std::endl;
+        return 1;
+    }
+    hvk::math::setRandomSeed(kSeed, 0);
+
+    const Inputs inputs = makeInputs();
+    const hvk::Sphere sphere(hvk::Vector(0.f, 0.f, -2.f), 0.5f);
+    const hvk::Plane plane(hvk::Vector(0.f, 0.f, -2.f), hvk::Vector(0.f, 0.f, 1.f));
+    const hvk::Box box(
+            hvk::Plane(hvk::Vector(0.f, 0.5f, -2.f), hvk::Vector(0.f, 1.f, 0.f)), // top
+            hvk::Plane(hvk::Vector(0.f, -0.5f, -2.f), hvk::Vector(0.f, -1.f, 0.f)), // bottom
+            hvk::Plane(hvk::Vector(0.f, 0.f, -1.5f), hvk::Vector(0.f, 0.f, 1.f)), // front
+            hvk::Plane(hvk::Vector(0.f, 0.f, -2.5f), hvk::Vector(0.f, 0.f, -1.f)), // back
+            hvk::Plane(hvk::Vector(-0.5f, 0.f, -2.f), hvk::Vector(-1.f, 0.f, 0.f)), // left
+            hvk::Plane(hvk::Vector(0.5f, 0.f, -2.f), hvk::Vector(1.f, 0.f, 0.f))); // right
+    const hvk::Camera camera(
+            hvk::Vector(-1.5f, .6f, 0.8f),
+            hvk::Vector(0.f, 0.f, -1.f),
+            hvk::Vector(0.f, 1.f, 0.f),
+            60.f,
+            16.f / 9.f,
+            0.001f,
+            2.f);
+
+    struct Result
+    {
+        const char* name;
+        double nanoseconds;
+    };
+    std::vector<Result> results;
+
+    results.push_back({ "SphereRayIntersect", measure(inputs.rays, numCalls, [&](const hvk::Ray& ray)
+    {
+        return static_cast<float>(hvk::hit::SphereRayIntersect(sphere, ray).value_or(0));
+    }) });
+    results.push_back({ "PlaneRayIntersect", measure(inputs.rays, numCalls, [&](const hvk::Ray& ray)
+    {
+        return static_cast<float>(hvk::hit::PlaneRayIntersect(plane, ray).value_or(0));
+    }) });
+    results.push_back({ "BoxRayIntersect", measure(inputs.rays, numCalls, [&](const hvk::Ray& ray)
+    {
+        const auto hit = hvk::hit::BoxRayIntersect(box, ray);
+        return hit.has_value() ? static_cast<float>(hit->second) : 0.f;
+    }) });
+
+    std::vector<size_t> indices(kNumInputs);
+    for (size_t i = 0; i < kNumInputs; ++i)
+    {
+        indices[i] = i;
+    }
+    results.push_back({ "Vector::Refract", measure(indices, numCalls, [&](size_t i)
+    {
+        return hvk::Vector::Refract(inputs.directions[i], inputs.normals[i], 1.0, 1.5).X();
+    }) });
+    results.push_back({ "Vector::RandomUnit", measure(indices, numCalls, [&](size_t)
+    {
+        return hvk::Vector::RandomUnit().X();
+    }) });
+    results.push_back({ "Camera::GetRay", measure(inputs.screenPoints, numCalls, [&](const std::pair<float, float>& point)
+    {
+        return camera.GetRay(point.first, point.second).getDirection().X();
+    }) });
+
+    // a task is queued, taken off the queue by a worker and counted done,
+    // and includes the wait for the last of them
+    {
+        hvk::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        const size_t numTasks = std::max<size_t>(1, numCalls / 64);
+        double best = std::numeric_limits<double>::max();
+        for (size_t repetition = 0; repetition < kRepetitions; ++repetition)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t task = 0; task < numTasks; ++task)
+            {
+                pool.QueueWork([]() {});
+            }
+            pool.Wait();
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / numTasks);
+        }
+        results.push_back({ "ThreadPool task", best });
+    }
+
+    std::cout << "{\n"
+              << "  \"calls\": " << numCalls << ",\n"
+              << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        std::cerr << results[i].name << ": " << results[i].nanoseconds << " ns" << std::endl;
+        std::cout << (i == 0 ? "\n" : ",\n")
+                  << "    { \"name\": \"" << results[i].name << "\", \"nsPerCall\": " << results[i].nanoseconds << " }";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+
+    return 0;
+}